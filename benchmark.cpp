@@ -0,0 +1,188 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+/*!
+ * @brief This file contains the main function for the benchmark executable.
+ *
+ * It computes the well blocks of a set of random wells in a grid with each of the calculator backends, and
+ * reports the throughput of each along with any differences from the Grid::Grid results.
+ */
+
+#include "wellindexcalculator.h"
+#include "cartesian_grid.h"
+#include "compact_grid.h"
+#include <Reservoir/grid/eclgrid.h>
+#include <boost/program_options.hpp>
+#include <boost/format.hpp>
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdlib.h>
+
+namespace po = boost::program_options;
+using namespace Reservoir::WellIndexCalculation;
+using namespace std;
+
+po::variables_map createVariablesMap(int argc, const char **argv) {
+    po::options_description desc("FieldOpt options");
+    desc.add_options()
+            ("help", "print help message")
+            ("grid,g", po::value<string>(),
+             "path to model grid file (e.g. *.GRID)")
+            ("wells,n", po::value<int>()->default_value(200),
+             "number of random wells")
+            ("seed,s", po::value<unsigned int>()->default_value(0),
+             "seed for the random wells")
+            ("approximate,a", po::value<double>()->default_value(0.01),
+             "tolerance of the approximate mode (largest relative error of each block)")
+            ;
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc, po::command_line_style::unix_style ^ po::command_line_style::allow_short), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        cout << "Usage: ./WellIndexCalcBenchmark --grid gridpath [options]" << endl;
+        cout << desc << endl;
+        exit(EXIT_SUCCESS);
+    }
+
+    assert(vm.count("grid"));
+    assert(vm["wells"].as<int>() > 0);
+    return vm;
+}
+
+/*!
+ * \brief Compute the well blocks of all wells, and print the throughput and the number of wells whose blocks
+ * differ from the reference.
+ */
+void benchmark(string name, const vector<pair<Eigen::Vector3d, Eigen::Vector3d>> &wells,
+               function<vector<IntersectedCell>(Eigen::Vector3d, Eigen::Vector3d)> compute_well_blocks,
+               vector<vector<IntersectedCell>> &reference) {
+    vector<vector<IntersectedCell>> results(wells.size());
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < wells.size(); ++i) {
+        results[i] = compute_well_blocks(wells[i].first, wells[i].second);
+    }
+    double wall_time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if (reference.empty())
+        reference = results;
+    int diffs = 0;
+    for (int i = 0; i < wells.size(); ++i) {
+        bool same = results[i].size() == reference[i].size();
+        for (int b = 0; same && b < results[i].size(); ++b) {
+            same = results[i][b].global_index() == reference[i][b].global_index()
+                   && fabs(results[i][b].well_index() - reference[i][b].well_index()) <= 1e-4 * reference[i][b].well_index();
+        }
+        diffs += same ? 0 : 1;
+    }
+    cout << boost::format("%-16s %10.1f wells/s   %d wells differ") % name % (wells.size() / wall_time) % diffs << endl;
+}
+
+int main(int argc, const char *argv[]) {
+    auto vm = createVariablesMap(argc, argv);
+    auto grid = new Reservoir::Grid::ECLGrid(vm["grid"].as<string>());
+    auto dims = grid->Dimensions();
+    int num_cells = dims.nx * dims.ny * dims.nz;
+
+    // Read the grid once, to find its extent and check whether it is a regular Cartesian grid
+    Eigen::Vector3d lower = Eigen::Vector3d::Constant(INFINITY);
+    Eigen::Vector3d upper = Eigen::Vector3d::Constant(-INFINITY);
+    vector<double> permx(num_cells), permy(num_cells), permz(num_cells);
+    auto first_cell = CellGeometry(grid->GetCell(0));
+    Eigen::Vector3d origin = first_cell.corners[0];
+    Eigen::Vector3d cell_size = first_cell.corners[7] - first_cell.corners[0];
+    bool regular = true;
+    for (int g = 0; g < num_cells; ++g) {
+        CellGeometry cell;
+        try {
+            cell = CellGeometry(grid->GetCell(g));
+        }
+        catch (const runtime_error &) { // Inactive cell
+            regular = false;
+            continue;
+        }
+        for (int c = 0; c < 8; ++c) {
+            lower = lower.cwiseMin(cell.corners[c]);
+            upper = upper.cwiseMax(cell.corners[c]);
+        }
+        Eigen::Vector3d expected_origin = origin + Eigen::Vector3d(cell.i, cell.j, cell.k).cwiseProduct(cell_size);
+        regular = regular && (cell.corners[0] - expected_origin).norm() < 1e-6 * cell_size.norm()
+                  && (cell.corners[7] - cell.corners[0] - cell_size).norm() < 1e-6 * cell_size.norm();
+        permx[g] = cell.permeability.x();
+        permy[g] = cell.permeability.y();
+        permz[g] = cell.permeability.z();
+    }
+
+    // Random wells inside the grid
+    mt19937 generator(vm["seed"].as<unsigned int>());
+    uniform_real_distribution<double> uniform(0.01, 0.99);
+    vector<pair<Eigen::Vector3d, Eigen::Vector3d>> wells;
+    auto wic = WellIndexCalculator(grid);
+    while (wells.size() < vm["wells"].as<int>()) {
+        Eigen::Vector3d heel = lower + (upper - lower).cwiseProduct(Eigen::Vector3d(uniform(generator), uniform(generator), uniform(generator)));
+        Eigen::Vector3d toe = lower + (upper - lower).cwiseProduct(Eigen::Vector3d(uniform(generator), uniform(generator), uniform(generator)));
+        try {
+            wic.ComputeWellBlocks(heel, toe, 0.190);
+        }
+        catch (const runtime_error &) { // Outside the grid or in an inactive cell
+            continue;
+        }
+        wells.push_back(make_pair(heel, toe));
+    }
+    cout << boost::format("%d random wells in a %dx%dx%d grid") % wells.size() % dims.nx % dims.ny % dims.nz << endl;
+
+    vector<vector<IntersectedCell>> reference;
+    benchmark("Grid::Grid", wells, [&wic](Eigen::Vector3d heel, Eigen::Vector3d toe) {
+        return wic.ComputeWellBlocks(heel, toe, 0.190);
+    }, reference);
+
+    double tolerance = vm["approximate"].as<double>();
+    benchmark("Approximate", wells, [&wic, tolerance](Eigen::Vector3d heel, Eigen::Vector3d toe) {
+        return wic.ComputeWellBlocksApproximate(heel, toe, 0.190, tolerance).well_blocks;
+    }, reference);
+
+    unique_ptr<CartesianGrid> cartesian_grid;
+    if (regular) {
+        cartesian_grid.reset(new CartesianGrid(origin, cell_size, dims.nx, dims.ny, dims.nz, permx, permy, permz));
+        auto cartesian_wic = WellIndexCalculatorCore<CartesianGrid>(cartesian_grid.get());
+        benchmark("CartesianGrid", wells, [&cartesian_wic](Eigen::Vector3d heel, Eigen::Vector3d toe) {
+            return cartesian_wic.ComputeWellBlocks(heel, toe, 0.190);
+        }, reference);
+    }
+    else {
+        cout << "CartesianGrid    skipped; the grid is not regular" << endl;
+    }
+
+    auto compact_grid = CompactGrid(grid);
+    auto compact_wic = WellIndexCalculatorCore<CompactGrid>(&compact_grid);
+    benchmark("CompactGrid", wells, [&compact_wic](Eigen::Vector3d heel, Eigen::Vector3d toe) {
+        return compact_wic.ComputeWellBlocks(heel, toe, 0.190);
+    }, reference);
+
+    delete grid;
+    return 0;
+}
@@ -0,0 +1,61 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef FIELDOPT_CANCELLATION_H
+#define FIELDOPT_CANCELLATION_H
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+namespace Reservoir {
+namespace WellIndexCalculation {
+
+    /*!
+     * \brief The CancellationToken class is used to cancel well block computations that are in progress.
+     *
+     * Copies of a token share the same state, so a token can be handed to a computation and cancelled
+     * by the caller later. The traversal checks the token between cells.
+     */
+    class CancellationToken {
+    public:
+        CancellationToken() : cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+
+        void Cancel() { cancelled_->store(true); }
+        bool IsCancelled() const { return cancelled_->load(std::memory_order_relaxed); }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> cancelled_;
+    };
+
+    /*!
+     * \brief Thrown by well block computations that are cancelled or run past their deadline.
+     */
+    class WellIndexCalculationCancelled : public std::runtime_error {
+    public:
+        WellIndexCalculationCancelled(const std::string &what) : std::runtime_error(what) {}
+    };
+}
+}
+
+#endif //FIELDOPT_CANCELLATION_H
@@ -0,0 +1,20 @@
+#include "cartesian_grid.h"
+
+namespace Reservoir {
+    namespace WellIndexCalculation {
+
+        CartesianGrid::CartesianGrid(Vector3d origin, Vector3d cell_size, int nx, int ny, int nz,
+                                     std::vector<double> permx, std::vector<double> permy, std::vector<double> permz) {
+            origin_ = origin;
+            cell_size_ = cell_size;
+            dims_.nx = nx;
+            dims_.ny = ny;
+            dims_.nz = nz;
+            if (permx.size() != nx * ny * nz || permy.size() != nx * ny * nz || permz.size() != nx * ny * nz)
+                throw std::runtime_error("CartesianGrid: There must be one permeability value per cell.");
+            permx_ = permx;
+            permy_ = permy;
+            permz_ = permz;
+        }
+    }
+}
@@ -0,0 +1,144 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef FIELDOPT_CARTESIANGRID_H
+#define FIELDOPT_CARTESIANGRID_H
+
+#include <cmath>
+#include <vector>
+#include <stdexcept>
+#include <Eigen/Core>
+#include "Reservoir/grid/grid.h"
+#include "Reservoir/grid/cell.h"
+#include "cell_geometry.h"
+
+namespace Reservoir {
+namespace WellIndexCalculation {
+    using namespace Eigen;
+
+    /*!
+     * \brief The CartesianGrid class is a regular, axis-aligned grid backend for WellIndexCalculatorCore.
+     *
+     * Unlike Grid::Grid, none of its methods are virtual, the cell enveloping a point is found
+     * directly from its coordinates, and the geometry of a cell is filled in place, so that
+     * WellIndexCalculatorCore<CartesianGrid> can inline all cell access and geometry. Cells are numbered
+     * like in Eclipse grids, i.e. i + nx*j + nx*ny*k, with k (and z) increasing downwards.
+     */
+    class CartesianGrid final {
+    public:
+        /*!
+         * \param origin The corner of cell (0,0,0) with the smallest coordinates.
+         * \param cell_size The size of each cell in the x, y and z directions.
+         * \param nx, ny, nz The number of cells in each direction.
+         * \param permx, permy, permz The permeabilities of each cell, ordered by global index.
+         */
+        CartesianGrid(Vector3d origin, Vector3d cell_size, int nx, int ny, int nz,
+                      std::vector<double> permx, std::vector<double> permy, std::vector<double> permz);
+
+        Grid::Grid::Dims Dimensions() const { return dims_; }
+
+        Grid::Cell GetCell(int global_index) const {
+            if (global_index < 0 || global_index >= permx_.size())
+                throw std::runtime_error("CartesianGrid::GetCell: Global index out of range.");
+            return GetCell(global_index % dims_.nx, (global_index / dims_.nx) % dims_.ny,
+                           global_index / (dims_.nx * dims_.ny));
+        }
+
+        Grid::Cell GetCell(int i, int j, int k) const {
+            CellGeometry cell;
+            if (!GetCellGeometry(i, j, k, cell))
+                throw std::runtime_error("CartesianGrid::GetCell: Index out of range.");
+            return cell.ToCell();
+        }
+
+        Grid::Cell GetCellEnvelopingPoint(Vector3d xyz) const {
+            CellGeometry cell;
+            GetCellGeometryEnvelopingPoint(xyz, cell);
+            return cell.ToCell();
+        }
+
+        /*!
+         * \brief Get the geometry of cell (i,j,k). Returns false if it is outside the grid.
+         */
+        bool GetCellGeometry(int i, int j, int k, CellGeometry &cell) const {
+            if (i < 0 || j < 0 || k < 0 || i >= dims_.nx || j >= dims_.ny || k >= dims_.nz)
+                return false;
+            int global_index = i + dims_.nx * (j + dims_.ny * k);
+            cell.global_index = global_index;
+            cell.i = i;
+            cell.j = j;
+            cell.k = k;
+            cell.volume = cell_size_.prod();
+            cell.porosity = 0.0;
+            cell.permeability = Vector3d(permx_[global_index], permy_[global_index], permz_[global_index]);
+            for (int c = 0; c < 8; ++c) {
+                cell.corners[c] = origin_ + Vector3d(i + (c & 1), j + ((c >> 1) & 1), k + (c >> 2)).cwiseProduct(cell_size_);
+            }
+            cell.center = 0.5 * (cell.corners[0] + cell.corners[7]);
+
+            // The faces are axis-aligned, in the order of CellGeometry::face_corners
+            for (int f = 0; f < 6; ++f) {
+                cell.face_points[f] = f % 2 == 0 ? cell.corners[0] : cell.corners[7];
+                cell.face_normals[f] = Vector3d::Zero();
+                cell.face_normals[f][2 - f / 2] = f % 2 == 0 ? 1.0 : -1.0;
+            }
+            return true;
+        }
+
+        /*!
+         * \brief Get the geometry of the cell containing a point. Throws a std::runtime_error if the point is
+         * outside the grid.
+         */
+        void GetCellGeometryEnvelopingPoint(const Vector3d &xyz, CellGeometry &cell) const {
+            Vector3d ijk = (xyz - origin_).cwiseQuotient(cell_size_);
+            int i = index_in_direction(ijk.x(), dims_.nx);
+            int j = index_in_direction(ijk.y(), dims_.ny);
+            int k = index_in_direction(ijk.z(), dims_.nz);
+            if (i < 0 || j < 0 || k < 0)
+                throw std::runtime_error("CartesianGrid::GetCellEnvelopingPoint: Point outside grid.");
+            GetCellGeometry(i, j, k, cell);
+        }
+
+    private:
+        Vector3d origin_;
+        Vector3d cell_size_;
+        Grid::Grid::Dims dims_;
+        std::vector<double> permx_;
+        std::vector<double> permy_;
+        std::vector<double> permz_;
+
+        /*!
+         * \brief The index of the cell containing a coordinate (in units of cells) in one direction, or -1 if it is
+         * outside the grid. Points on the far boundary belong to the last cell.
+         */
+        static int index_in_direction(double coordinate, int n) {
+            int index = (int)std::floor(coordinate);
+            if (index == n && coordinate == n)
+                index = n - 1;
+            return index >= 0 && index < n ? index : -1;
+        }
+    };
+}
+}
+
+#endif //FIELDOPT_CARTESIANGRID_H
@@ -0,0 +1,209 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef FIELDOPT_CELLGEOMETRY_H
+#define FIELDOPT_CELLGEOMETRY_H
+
+#include <cmath>
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include "Reservoir/grid/cell.h"
+
+namespace Reservoir {
+namespace WellIndexCalculation {
+    using namespace Eigen;
+
+    /*!
+     * \brief The CellGeometry struct is the lightweight description of a cell used in the hot path of
+     * WellIndexCalculatorCore.
+     *
+     * Unlike Grid::Cell it has a fixed size and never allocates, so grid backends can fill it in place
+     * and the traversal and well index computations can be inlined. The corners are in the same order
+     * as in Grid::Cell. Each face is represented by a plane, given by a point on the face and the unit
+     * normal pointing into the cell.
+     */
+    struct CellGeometry {
+        int global_index = -1;
+        int i, j, k; //!< The (i,j,k) index of the cell.
+        double volume;
+        double porosity;
+        Vector3d permeability; //!< (permx, permy, permz).
+        Vector3d center;
+        Vector3d corners[8];
+        Vector3d face_points[6]; //!< A point on the plane of each face.
+        Vector3d face_normals[6]; //!< The unit normal of each face, pointing into the cell.
+
+        CellGeometry() {}
+
+        /*!
+         * \brief Copy the geometry of a cell, using the face planes of the cell.
+         */
+        explicit CellGeometry(const Grid::Cell &cell) {
+            global_index = cell.global_index();
+            i = cell.ijk_index().i();
+            j = cell.ijk_index().j();
+            k = cell.ijk_index().k();
+            volume = cell.volume();
+            porosity = cell.porosity();
+            permeability = Vector3d(cell.permx(), cell.permy(), cell.permz());
+            center = cell.center();
+            auto cell_corners = cell.corners();
+            for (int c = 0; c < 8; ++c) {
+                corners[c] = cell_corners[c];
+            }
+            auto faces = cell.faces();
+            for (int f = 0; f < 6; ++f) {
+                face_points[f] = faces[f].corners[0];
+                face_normals[f] = faces[f].normal_vector.normalized();
+                if (face_normals[f].dot(center - face_points[f]) < 0)
+                    face_normals[f] = -face_normals[f];
+            }
+        }
+
+        /*!
+         * \brief Compute the face planes from the corners. The plane of a face goes through the mean of its
+         * corners, with the normal given by the cross product of its diagonals.
+         */
+        void SetFacesFromCorners() {
+            for (int f = 0; f < 6; ++f) {
+                const int *c = face_corners()[f];
+                face_points[f] = 0.25 * (corners[c[0]] + corners[c[1]] + corners[c[2]] + corners[c[3]]);
+                face_normals[f] = (corners[c[2]] - corners[c[0]]).cross(corners[c[3]] - corners[c[1]]).normalized();
+                if (face_normals[f].dot(center - face_points[f]) < 0)
+                    face_normals[f] = -face_normals[f];
+            }
+        }
+
+        /*!
+         * \brief Check whether a point is inside the cell, or at most slack outside of any of its faces.
+         */
+        bool Contains(const Vector3d &point, double slack) const {
+            return distance_outside(point) <= slack;
+        }
+
+        /*!
+         * \brief The largest distance of a point outside the face planes of the cell; zero or negative
+         * if the point is inside.
+         */
+        double distance_outside(const Vector3d &point) const {
+            double distance = -INFINITY;
+            for (int f = 0; f < 6; ++f) {
+                distance = std::max(distance, -face_normals[f].dot(point - face_points[f]));
+            }
+            return distance;
+        }
+
+        /*!
+         * \brief The largest distance between a corner of a face and the plane of the face, as computed
+         * by SetFacesFromCorners; zero for planar faces.
+         */
+        double face_warp(int face) const {
+            const int *c = face_corners()[face];
+            Vector3d point = 0.25 * (corners[c[0]] + corners[c[1]] + corners[c[2]] + corners[c[3]]);
+            Vector3d normal = (corners[c[2]] - corners[c[0]]).cross(corners[c[3]] - corners[c[1]]).normalized();
+            double warp = 0.0;
+            for (int n = 0; n < 4; ++n) {
+                warp = std::max(warp, std::abs(normal.dot(corners[c[n]] - point)));
+            }
+            return warp;
+        }
+
+        /*!
+         * \brief The distance from a point in the cell, along a direction, to where the line leaves the cell
+         * through one of the face planes.
+         * \param point The start point.
+         * \param direction The unit direction of the line.
+         * \param face Set to the face the line leaves through, or -1 if the direction is zero.
+         * \return The distance; negative if the point is outside the plane of the face, and infinite if the
+         * direction is zero.
+         */
+        double exit_distance(const Vector3d &point, const Vector3d &direction, int &face) const {
+            double distance = INFINITY;
+            face = -1;
+            for (int f = 0; f < 6; ++f) {
+                double normal_dot_direction = face_normals[f].dot(direction);
+                if (normal_dot_direction < 0) { // Moving out through the face
+                    double t = face_normals[f].dot(face_points[f] - point) / normal_dot_direction;
+                    if (t < distance) {
+                        distance = t;
+                        face = f;
+                    }
+                }
+            }
+            return distance;
+        }
+
+        /*!
+         * \brief Bound the distance along a line between where it crosses the plane of a face, as computed by
+         * SetFacesFromCorners, and where it crosses the face itself.
+         *
+         * The face may be taken as the plane through any three of its corners, or as any surface within the
+         * hull of its corners (e.g. the bilinear one); all of these cross the line between the planes through
+         * three of the corners, so the bound is the largest distance to one of them.
+         * \param face The face.
+         * \param point The point where the line crosses the plane of the face.
+         * \param direction The unit direction of the line.
+         * \return The bound; zero for planar faces, and infinite if the line is parallel to the face.
+         */
+        double crossing_uncertainty(int face, const Vector3d &point, const Vector3d &direction) const {
+            const int *c = face_corners()[face];
+            double uncertainty = 0.0;
+            for (int n = 0; n < 4; ++n) { // The plane through all corners but c[n]
+                const Vector3d &a = corners[c[(n + 1) % 4]];
+                Vector3d normal = (corners[c[(n + 2) % 4]] - a).cross(corners[c[(n + 3) % 4]] - a);
+                double normal_dot_direction = normal.dot(direction);
+                if (std::abs(normal_dot_direction) <= 1e-12 * normal.norm())
+                    return INFINITY;
+                uncertainty = std::max(uncertainty, std::abs(normal.dot(a - point) / normal_dot_direction));
+            }
+            return uncertainty;
+        }
+
+        Vector3d xvec() const { return corners[5] - corners[4]; }
+        Vector3d yvec() const { return corners[6] - corners[4]; }
+        Vector3d zvec() const { return corners[0] - corners[4]; }
+
+        /*!
+         * \brief Create a Grid::Cell with this geometry.
+         */
+        Grid::Cell ToCell() const {
+            return Grid::Cell(global_index, Grid::IJKCoordinate(i, j, k), volume, porosity,
+                              permeability.x(), permeability.y(), permeability.z(), center,
+                              std::vector<Vector3d>(corners, corners + 8));
+        }
+
+        /*!
+         * \brief The corners of each face, in order around the face. The faces are, in order, the ones
+         * towards -k, +k, -j, +j, -i and +i.
+         */
+        static const int (*face_corners())[4] {
+            static const int corners_of_face[6][4] = {{0, 1, 3, 2}, {4, 5, 7, 6}, {0, 1, 5, 4},
+                                                      {2, 3, 7, 6}, {0, 2, 6, 4}, {1, 3, 7, 5}};
+            return corners_of_face;
+        }
+    };
+}
+}
+
+#endif //FIELDOPT_CELLGEOMETRY_H
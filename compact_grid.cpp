@@ -0,0 +1,267 @@
+#include <stdexcept>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+#include <unistd.h>
+#include "compact_grid.h"
+#include "grid_access.h"
+
+namespace Reservoir {
+    namespace WellIndexCalculation {
+
+        namespace {
+            const uint64_t snapshot_magic = 0x5749434347524944; // "WICCGRID"
+            const uint32_t snapshot_version = 1;
+
+            struct SnapshotHeader {
+                uint64_t magic;
+                uint32_t version;
+                int32_t nx, ny, nz;
+                uint64_t grid_hash;
+                uint64_t num_bucket_cells;
+                double bucket_origin[2];
+                double bucket_size[2];
+            };
+
+            template<class T>
+            void write_values(std::ofstream &file, const std::vector<T> &values) {
+                file.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+            }
+
+            template<class T>
+            void read_values(std::ifstream &file, std::vector<T> &values, size_t size) {
+                values.resize(size);
+                file.read(reinterpret_cast<char *>(values.data()), size * sizeof(T));
+            }
+        }
+
+        CompactGrid::CompactGrid(Grid::Grid *grid) {
+            dims_ = GridAccess<Grid::Grid>::Dimensions(grid);
+            int num_cells = dims_.nx * dims_.ny * dims_.nz;
+
+            // Copy the active cells, relative to the first corner of the topmost active cell in each column
+            active_ = std::vector<bool>(num_cells, false);
+            corners_ = std::vector<float>(24 * num_cells, 0.0f);
+            perms_ = std::vector<float>(3 * num_cells, 0.0f);
+            column_origins_ = std::vector<Vector3d>(dims_.nx * dims_.ny, Vector3d::Zero());
+            std::vector<bool> column_has_origin(dims_.nx * dims_.ny, false);
+            std::vector<int> cell_indices;
+            for (int i = 0; i < num_cells; ++i) {
+                Grid::Cell cell;
+                try {
+                    cell = GridAccess<Grid::Grid>::Cell(grid, i);
+                }
+                catch (const std::runtime_error &) { // Inactive cell
+                    continue;
+                }
+                int column = i % (dims_.nx * dims_.ny);
+                if (!column_has_origin[column]) {
+                    column_origins_[column] = cell.corners()[0];
+                    column_has_origin[column] = true;
+                }
+                cell_indices.push_back(i);
+                active_[i] = true;
+
+                auto corners = cell.corners();
+                for (int c = 0; c < 8; ++c) {
+                    for (int d = 0; d < 3; ++d) {
+                        corners_[24 * i + 3 * c + d] = corners[c][d] - column_origins_[column][d];
+                    }
+                }
+                perms_[3 * i] = cell.permx();
+                perms_[3 * i + 1] = cell.permy();
+                perms_[3 * i + 2] = cell.permz();
+            }
+            if (cell_indices.empty())
+                throw std::runtime_error("CompactGrid: The grid has no active cells.");
+
+            Vector3d min_corner = Vector3d::Constant(INFINITY);
+            Vector3d max_corner = Vector3d::Constant(-INFINITY);
+            for (int i : cell_indices) {
+                for (int c = 0; c < 8; ++c) {
+                    min_corner = min_corner.cwiseMin(corner(i, c));
+                    max_corner = max_corner.cwiseMax(corner(i, c));
+                }
+            }
+
+            // One bucket per column; add every cell to all buckets overlapped by its bounding box
+            bucket_origin_ = Vector2d(min_corner.x(), min_corner.y());
+            bucket_size_ = Vector2d((max_corner.x() - min_corner.x()) / dims_.nx,
+                                    (max_corner.y() - min_corner.y()) / dims_.ny);
+            std::vector<std::vector<int32_t>> buckets(dims_.nx * dims_.ny);
+            for (int i : cell_indices) {
+                Vector3d lower = corner(i, 0);
+                Vector3d upper = corner(i, 0);
+                for (int c = 1; c < 8; ++c) {
+                    lower = lower.cwiseMin(corner(i, c));
+                    upper = upper.cwiseMax(corner(i, c));
+                }
+                int bx0 = std::max(0, (int)std::floor((lower.x() - bucket_origin_.x()) / bucket_size_.x()));
+                int by0 = std::max(0, (int)std::floor((lower.y() - bucket_origin_.y()) / bucket_size_.y()));
+                int bx1 = std::min(dims_.nx - 1, (int)std::floor((upper.x() - bucket_origin_.x()) / bucket_size_.x()));
+                int by1 = std::min(dims_.ny - 1, (int)std::floor((upper.y() - bucket_origin_.y()) / bucket_size_.y()));
+                for (int by = by0; by <= by1; ++by) {
+                    for (int bx = bx0; bx <= bx1; ++bx) {
+                        buckets[bx + dims_.nx * by].push_back(i);
+                    }
+                }
+            }
+            bucket_offsets_.push_back(0);
+            for (auto &bucket : buckets) {
+                bucket_cells_.insert(bucket_cells_.end(), bucket.begin(), bucket.end());
+                bucket_offsets_.push_back(bucket_cells_.size());
+            }
+        }
+
+        CompactGrid::CompactGrid(const std::string &path, uint64_t grid_hash) {
+            std::ifstream file(path, std::ios::binary);
+            SnapshotHeader header;
+            if (!file.read(reinterpret_cast<char *>(&header), sizeof(SnapshotHeader))
+                || header.magic != snapshot_magic || header.version != snapshot_version)
+                throw std::runtime_error("CompactGrid: Unable to read snapshot " + path);
+            if (header.grid_hash != grid_hash)
+                throw std::runtime_error("CompactGrid: The snapshot " + path + " was saved for another grid.");
+
+            dims_ = Grid::Grid::Dims{header.nx, header.ny, header.nz};
+            size_t num_columns = (size_t)dims_.nx * dims_.ny;
+            size_t num_cells = num_columns * dims_.nz;
+            bucket_origin_ = Vector2d(header.bucket_origin[0], header.bucket_origin[1]);
+            bucket_size_ = Vector2d(header.bucket_size[0], header.bucket_size[1]);
+            std::vector<double> origins;
+            std::vector<char> active;
+            read_values(file, origins, 3 * num_columns);
+            read_values(file, corners_, 24 * num_cells);
+            read_values(file, perms_, 3 * num_cells);
+            read_values(file, active, num_cells);
+            read_values(file, bucket_offsets_, num_columns + 1);
+            read_values(file, bucket_cells_, header.num_bucket_cells);
+            if (!file || bucket_offsets_.back() != bucket_cells_.size())
+                throw std::runtime_error("CompactGrid: Unable to read snapshot " + path);
+
+            column_origins_.resize(num_columns);
+            for (size_t c = 0; c < num_columns; ++c) {
+                column_origins_[c] = Vector3d(origins[3 * c], origins[3 * c + 1], origins[3 * c + 2]);
+            }
+            active_ = std::vector<bool>(active.begin(), active.end());
+        }
+
+        void CompactGrid::Save(const std::string &path, uint64_t grid_hash) const {
+            SnapshotHeader header = {snapshot_magic, snapshot_version, dims_.nx, dims_.ny, dims_.nz, grid_hash,
+                                     bucket_cells_.size(), {bucket_origin_.x(), bucket_origin_.y()},
+                                     {bucket_size_.x(), bucket_size_.y()}};
+            std::vector<double> origins;
+            for (auto &origin : column_origins_) {
+                origins.insert(origins.end(), origin.data(), origin.data() + 3);
+            }
+
+            std::string temporary_path = path + "." + std::to_string(getpid());
+            {
+                std::ofstream file(temporary_path, std::ios::binary);
+                file.write(reinterpret_cast<const char *>(&header), sizeof(SnapshotHeader));
+                write_values(file, origins);
+                write_values(file, corners_);
+                write_values(file, perms_);
+                write_values(file, std::vector<char>(active_.begin(), active_.end()));
+                write_values(file, bucket_offsets_);
+                write_values(file, bucket_cells_);
+                if (!file)
+                    throw std::runtime_error("CompactGrid: Unable to write snapshot " + path);
+            }
+            if (std::rename(temporary_path.c_str(), path.c_str()) != 0)
+                throw std::runtime_error("CompactGrid: Unable to write snapshot " + path);
+        }
+
+        Grid::Grid::Dims CompactGrid::Dimensions() const {
+            return dims_;
+        }
+
+        bool CompactGrid::IsActive(int global_index) const {
+            return global_index >= 0 && global_index < active_.size() && active_[global_index];
+        }
+
+        Grid::Cell CompactGrid::GetCell(int global_index) const {
+            if (!IsActive(global_index))
+                throw std::runtime_error("CompactGrid::GetCell: Cell is not in the grid or inactive.");
+            CellGeometry cell;
+            cell_geometry(global_index, cell);
+            return cell.ToCell();
+        }
+
+        Grid::Cell CompactGrid::GetCellEnvelopingPoint(Vector3d xyz) const {
+            CellGeometry cell;
+            GetCellGeometryEnvelopingPoint(xyz, cell);
+            return cell.ToCell();
+        }
+
+        bool CompactGrid::GetCellGeometry(int i, int j, int k, CellGeometry &cell) const {
+            if (i < 0 || j < 0 || k < 0 || i >= dims_.nx || j >= dims_.ny || k >= dims_.nz)
+                return false;
+            int global_index = i + dims_.nx * (j + dims_.ny * k);
+            if (!active_[global_index])
+                return false;
+            cell_geometry(global_index, cell);
+            return true;
+        }
+
+        void CompactGrid::GetCellGeometryEnvelopingPoint(const Vector3d &xyz, CellGeometry &cell) const {
+            int bucket = bucket_index(xyz);
+            if (bucket >= 0) {
+                for (int n = bucket_offsets_[bucket]; n < bucket_offsets_[bucket + 1]; ++n) {
+                    int i = bucket_cells_[n];
+
+                    // Check the bounding box before expanding the cell
+                    Vector3d lower = corner(i, 0);
+                    Vector3d upper = corner(i, 0);
+                    for (int c = 1; c < 8; ++c) {
+                        lower = lower.cwiseMin(corner(i, c));
+                        upper = upper.cwiseMax(corner(i, c));
+                    }
+                    if ((xyz.array() < lower.array()).any() || (xyz.array() > upper.array()).any())
+                        continue;
+
+                    cell_geometry(i, cell);
+                    if (cell.Contains(xyz, 0.0))
+                        return;
+                }
+            }
+            throw std::runtime_error("CompactGrid::GetCellEnvelopingPoint: Point outside grid.");
+        }
+
+        void CompactGrid::cell_geometry(int global_index, CellGeometry &cell) const {
+            cell.global_index = global_index;
+            cell.i = global_index % dims_.nx;
+            cell.j = (global_index / dims_.nx) % dims_.ny;
+            cell.k = global_index / (dims_.nx * dims_.ny);
+            cell.volume = 0.0;
+            cell.porosity = 0.0;
+            cell.permeability = Vector3d(perms_[3 * global_index], perms_[3 * global_index + 1], perms_[3 * global_index + 2]);
+            cell.center = Vector3d::Zero();
+            for (int c = 0; c < 8; ++c) {
+                cell.corners[c] = corner(global_index, c);
+                cell.center += cell.corners[c] / 8.0;
+            }
+            cell.SetFacesFromCorners();
+        }
+
+        size_t CompactGrid::memory_usage() const {
+            return corners_.size() * sizeof(float) + perms_.size() * sizeof(float) + active_.size() / 8
+                   + column_origins_.size() * sizeof(Vector3d)
+                   + bucket_offsets_.size() * sizeof(uint32_t) + bucket_cells_.size() * sizeof(int32_t);
+        }
+
+        int CompactGrid::bucket_index(const Vector3d &xyz) const {
+            int bx = (int)std::floor((xyz.x() - bucket_origin_.x()) / bucket_size_.x());
+            int by = (int)std::floor((xyz.y() - bucket_origin_.y()) / bucket_size_.y());
+
+            // Points on the far boundary belong to the last bucket
+            if (bx == dims_.nx && xyz.x() - bucket_origin_.x() <= bucket_size_.x() * dims_.nx)
+                bx = dims_.nx - 1;
+            if (by == dims_.ny && xyz.y() - bucket_origin_.y() <= bucket_size_.y() * dims_.ny)
+                by = dims_.ny - 1;
+            if (bx < 0 || by < 0 || bx >= dims_.nx || by >= dims_.ny)
+                return -1;
+            return bx + dims_.nx * by;
+        }
+    }
+}
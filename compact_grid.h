@@ -0,0 +1,145 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef FIELDOPT_COMPACTGRID_H
+#define FIELDOPT_COMPACTGRID_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <Eigen/Core>
+#include "Reservoir/grid/grid.h"
+#include "Reservoir/grid/cell.h"
+#include "cell_geometry.h"
+
+namespace Reservoir {
+namespace WellIndexCalculation {
+    using namespace Eigen;
+
+    /*!
+     * \brief The CompactGrid class is a memory-efficient copy of the geometry and permeabilities of a grid,
+     * for use as a backend for WellIndexCalculatorCore on very large models.
+     *
+     * Corners are stored as float32 coordinates relative to an origin per column of cells (the first corner
+     * of its topmost active cell), and permeabilities as float32; together this takes 108 bytes per cell,
+     * plus 24 bytes for the origin of each column, as opposed to 192 bytes for the double precision corners
+     * alone. Corners are expanded to doubles when a cell is requested. Points are located through a uniform
+     * bucket grid in the xy-plane with one bucket per column of cells, where each bucket lists the cells
+     * whose bounding box overlaps it; this adds 4 bytes per column and cell-bucket pair.
+     *
+     * The error of the corner coordinates is about 1e-7 of the extent of the column, so it does not grow
+     * with the extent of the grid or its distance from the coordinate origin. Cells in the same column round
+     * their shared corners in the same way; corners shared between columns may differ by about that error,
+     * which is far below the step the traversal takes past each exit point. Volumes and porosities are not
+     * stored, and are zero in the cells returned.
+     *
+     * A compact grid only needs the full grid to be created. It can be saved to a snapshot file and loaded
+     * from it later, so that only the compact copy is held in memory, e.g. with WellIndexCalculatorCore<CompactGrid>.
+     */
+    class CompactGrid final {
+    public:
+        /*!
+         * \brief Create a compact copy of a grid. Inactive cells are skipped.
+         */
+        CompactGrid(Grid::Grid *grid);
+
+        /*!
+         * \brief Load a compact grid from a snapshot file written by Save. Throws a std::runtime_error if the file
+         * can not be read, or was saved for another grid.
+         * \param path Path to the snapshot file.
+         * \param grid_hash Content hash of the grid the snapshot should have been created from
+         * (see WellBlockCache::HashGrid).
+         */
+        CompactGrid(const std::string &path, uint64_t grid_hash);
+
+        /*!
+         * \brief Save the compact grid to a snapshot file. The file is replaced atomically, so concurrent
+         * processes loading it never see a partial file.
+         * \param path Path to the snapshot file.
+         * \param grid_hash Content hash of the grid the compact grid was created from.
+         */
+        void Save(const std::string &path, uint64_t grid_hash) const;
+
+        Grid::Grid::Dims Dimensions() const;
+
+        /*!
+         * \brief Check whether a cell was active in the grid the compact grid was created from.
+         */
+        bool IsActive(int global_index) const;
+
+        Grid::Cell GetCell(int global_index) const;
+
+        Grid::Cell GetCellEnvelopingPoint(Vector3d xyz) const;
+
+        /*!
+         * \brief Get the geometry of cell (i,j,k), with the corners expanded to double precision. Returns false
+         * if it is outside the grid or inactive.
+         */
+        bool GetCellGeometry(int i, int j, int k, CellGeometry &cell) const;
+
+        /*!
+         * \brief Get the geometry of the cell containing a point. Throws a std::runtime_error if the point is
+         * outside the grid.
+         */
+        void GetCellGeometryEnvelopingPoint(const Vector3d &xyz, CellGeometry &cell) const;
+
+        /*!
+         * \brief The approximate number of bytes used to store the grid.
+         */
+        size_t memory_usage() const;
+
+    private:
+        Grid::Grid::Dims dims_;
+        std::vector<Vector3d> column_origins_; //!< The origin of each column of cells, indexed by i + nx*j.
+        std::vector<float> corners_; //!< 8 x (x, y, z) per cell, relative to the origin of its column.
+        std::vector<float> perms_; //!< (permx, permy, permz) per cell.
+        std::vector<bool> active_;
+
+        // Uniform bucket grid in the xy-plane, in compressed row format
+        Vector2d bucket_origin_;
+        Vector2d bucket_size_;
+        std::vector<uint32_t> bucket_offsets_; //!< Start of the cells of each bucket in bucket_cells_.
+        std::vector<int32_t> bucket_cells_;
+
+        /*!
+         * \brief The corner of a cell, expanded to double precision.
+         */
+        Vector3d corner(int global_index, int corner) const {
+            const float *c = &corners_[24 * global_index + 3 * corner];
+            return column_origins_[global_index % (dims_.nx * dims_.ny)] + Vector3d(c[0], c[1], c[2]);
+        }
+
+        /*!
+         * \brief The index of the bucket containing a point, or -1 if it is outside the grid.
+         */
+        int bucket_index(const Vector3d &xyz) const;
+
+        /*!
+         * \brief Fill in the geometry of an active cell.
+         */
+        void cell_geometry(int global_index, CellGeometry &cell) const;
+    };
+}
+}
+
+#endif //FIELDOPT_COMPACTGRID_H
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include "executor.h"
+
+namespace Reservoir {
+    namespace WellIndexCalculation {
+
+        Executor::Executor(int num_threads) {
+            if (num_threads <= 0)
+                num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+            for (int t = 0; t < num_threads; ++t) {
+                workers_.push_back(std::thread([this]() {
+                    while (true) {
+                        std::function<void()> task;
+                        {
+                            std::unique_lock<std::mutex> lock(mutex_);
+                            task_available_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+                            if (tasks_.empty()) // Stopping, and the queue has been drained
+                                return;
+                            task = std::move(tasks_.front());
+                            tasks_.pop();
+                        }
+                        task();
+                    }
+                }));
+            }
+        }
+
+        Executor::~Executor() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            task_available_.notify_all();
+            for (auto &worker : workers_) {
+                worker.join();
+            }
+        }
+
+        void Executor::Submit(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                tasks_.push(std::move(task));
+            }
+            task_available_.notify_one();
+        }
+
+        void Executor::ParallelFor(int num_tasks, std::function<void(int)> task) {
+            if (num_tasks <= 0)
+                return;
+
+            // The batch is shared with the helper tasks, which may start after all its tasks are done
+            struct Batch {
+                std::function<void(int)> task;
+                int num_tasks;
+                std::atomic<int> next_task{0};
+                std::atomic<bool> failed{false};
+                std::exception_ptr error;
+                int num_finished = 0;
+                std::mutex mutex;
+                std::condition_variable finished;
+
+                void Run() {
+                    for (int i = next_task++; i < num_tasks; i = next_task++) {
+                        std::exception_ptr task_error;
+                        if (!failed) {
+                            try {
+                                task(i);
+                            }
+                            catch (...) {
+                                task_error = std::current_exception();
+                                failed = true;
+                            }
+                        }
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (task_error && !error)
+                            error = task_error;
+                        if (++num_finished == num_tasks)
+                            finished.notify_all();
+                    }
+                }
+            };
+            auto batch = std::make_shared<Batch>();
+            batch->task = std::move(task);
+            batch->num_tasks = num_tasks;
+
+            for (int t = 0; t < std::min(num_tasks - 1, num_threads()); ++t) {
+                Submit([batch]() { batch->Run(); });
+            }
+            batch->Run();
+
+            std::unique_lock<std::mutex> lock(batch->mutex);
+            batch->finished.wait(lock, [&batch]() { return batch->num_finished == batch->num_tasks; });
+            if (batch->error)
+                std::rethrow_exception(batch->error);
+        }
+
+        int Executor::num_threads() const {
+            return workers_.size();
+        }
+
+        Executor &Executor::Shared() {
+            static Executor shared_executor;
+            return shared_executor;
+        }
+    }
+}
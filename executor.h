@@ -0,0 +1,88 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef FIELDOPT_EXECUTOR_H
+#define FIELDOPT_EXECUTOR_H
+
+#include <functional>
+#include <queue>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Reservoir {
+namespace WellIndexCalculation {
+
+    /*!
+     * \brief The Executor class is a fixed size pool of worker threads running submitted tasks in order.
+     *
+     * A single shared executor is used for asynchronous and parallel well block computations, so that the
+     * number of threads stays bounded no matter how many computations are dispatched.
+     */
+    class Executor {
+    public:
+        /*!
+         * \param num_threads The number of worker threads. Defaults to the number of hardware threads.
+         */
+        Executor(int num_threads = 0);
+
+        /*!
+         * \brief Run the tasks still in the queue, then stop the workers. Every submitted task runs, so the
+         * futures of queued computations are always satisfied (cancelled computations throw when they start).
+         */
+        ~Executor();
+
+        Executor(const Executor &) = delete;
+        Executor &operator=(const Executor &) = delete;
+
+        void Submit(std::function<void()> task);
+
+        /*!
+         * \brief Run task(0) ... task(num_tasks - 1) on the workers and the calling thread, and wait for all of
+         * them to finish.
+         *
+         * The calling thread takes part in the work, so this may be called from inside a task without
+         * deadlocking, even when all the workers are busy. If a task throws, the tasks that have not started
+         * yet are skipped, and the first exception is rethrown.
+         */
+        void ParallelFor(int num_tasks, std::function<void(int)> task);
+
+        int num_threads() const;
+
+        /*!
+         * \brief The executor shared by all asynchronous and parallel computations.
+         */
+        static Executor &Shared();
+
+    private:
+        std::vector<std::thread> workers_;
+        std::queue<std::function<void()>> tasks_;
+        std::mutex mutex_;
+        std::condition_variable task_available_;
+        bool stopping_ = false;
+    };
+}
+}
+
+#endif //FIELDOPT_EXECUTOR_H
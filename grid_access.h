@@ -0,0 +1,122 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef FIELDOPT_GRIDACCESS_H
+#define FIELDOPT_GRIDACCESS_H
+
+#include <mutex>
+#include <cstdint>
+#include <stdexcept>
+#include <Eigen/Core>
+#include "Reservoir/grid/grid.h"
+#include "Reservoir/grid/cell.h"
+#include "cell_geometry.h"
+
+namespace Reservoir {
+namespace WellIndexCalculation {
+    using namespace Eigen;
+
+    /*!
+     * \brief The GridAccess struct template is how WellIndexCalculatorCore accesses the cells of a grid.
+     *
+     * Grid backends (e.g. CartesianGrid and CompactGrid) provide GetCellGeometryEnvelopingPoint and
+     * GetCellGeometry, filling a CellGeometry in place. They are immutable after construction, so any number
+     * of threads may read from them concurrently. The specialization for the abstract Grid::Grid copies the
+     * geometry from the Grid::Cell objects returned by the grid.
+     */
+    template<class GridType>
+    struct GridAccess {
+        /*!
+         * \brief Get the cell containing a point. Throws a std::runtime_error if the point is outside the grid.
+         */
+        static void CellEnvelopingPoint(GridType *grid, const Vector3d &point, CellGeometry &cell) {
+            grid->GetCellGeometryEnvelopingPoint(point, cell);
+        }
+
+        /*!
+         * \brief Get the cell (i,j,k). Returns false if it is outside the grid or inactive.
+         */
+        static bool CellAt(GridType *grid, int i, int j, int k, CellGeometry &cell) {
+            return grid->GetCellGeometry(i, j, k, cell);
+        }
+
+        static Grid::Grid::Dims Dimensions(GridType *grid) {
+            return grid->Dimensions();
+        }
+    };
+
+    /*!
+     * Grid::Grid implementations are not necessarily thread safe (e.g. ECLGrid reads through a single ERT
+     * grid handle), so every call into a Grid::Grid made by the calculators, the coefficient table and the
+     * result cache holds the mutex of that grid. This makes it safe to share one grid between calculators
+     * running on different threads; the grid accesses are serialized, while the geometry and well index
+     * computations run in parallel. Code calling the grid directly while calculators use it on other threads
+     * must hold Mutex(grid) as well.
+     */
+    template<>
+    struct GridAccess<Grid::Grid> {
+        static void CellEnvelopingPoint(Grid::Grid *grid, const Vector3d &point, CellGeometry &cell) {
+            std::lock_guard<std::mutex> lock(Mutex(grid));
+            cell = CellGeometry(grid->GetCellEnvelopingPoint(point));
+        }
+
+        static bool CellAt(Grid::Grid *grid, int i, int j, int k, CellGeometry &cell) {
+            std::lock_guard<std::mutex> lock(Mutex(grid));
+            auto dims = grid->Dimensions();
+            if (i < 0 || j < 0 || k < 0 || i >= dims.nx || j >= dims.ny || k >= dims.nz)
+                return false;
+            try {
+                cell = CellGeometry(grid->GetCell(i, j, k));
+            }
+            catch (const std::runtime_error &) { // Inactive cell
+                return false;
+            }
+            return true;
+        }
+
+        /*!
+         * \brief Get a cell by its global index. Throws a std::runtime_error if it is outside the grid or inactive.
+         */
+        static Grid::Cell Cell(Grid::Grid *grid, int global_index) {
+            std::lock_guard<std::mutex> lock(Mutex(grid));
+            return grid->GetCell(global_index);
+        }
+
+        static Grid::Grid::Dims Dimensions(Grid::Grid *grid) {
+            std::lock_guard<std::mutex> lock(Mutex(grid));
+            return grid->Dimensions();
+        }
+
+        /*!
+         * \brief The mutex guarding a grid. The mutexes are striped by the address of the grid, so separate
+         * grids (e.g. one per thread in WellIndexCalcReplay) rarely share one.
+         */
+        static std::mutex &Mutex(const Grid::Grid *grid) {
+            static std::mutex mutexes[61];
+            return mutexes[(reinterpret_cast<uintptr_t>(grid) >> 4) % 61];
+        }
+    };
+}
+}
+
+#endif //FIELDOPT_GRIDACCESS_H
@@ -7,6 +7,17 @@ namespace Reservoir {
             return std::vector<Vector3d>({entry_point_, exit_point_});
         }
 
+        std::vector<std::pair<Vector3d, Vector3d>> IntersectedCell::segments() const {
+            std::vector<std::pair<Vector3d, Vector3d>> segments;
+            segments.push_back(std::make_pair(entry_point_, exit_point_));
+            segments.insert(segments.end(), additional_segments_.begin(), additional_segments_.end());
+            return segments;
+        }
+
+        void IntersectedCell::add_segment(const Vector3d &entry_point, const Vector3d &exit_point) {
+            additional_segments_.push_back(std::make_pair(entry_point, exit_point));
+        }
+
         Vector3d IntersectedCell::xvec() const {
             return corners()[5] - corners()[4];
         }
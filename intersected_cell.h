@@ -37,9 +37,23 @@ namespace WellIndexCalculation {
     public:
         IntersectedCell() {}
         IntersectedCell(const Grid::Cell &cell) : Grid::Cell(cell) {};
+        IntersectedCell(Grid::Cell &&cell) : Grid::Cell(std::move(cell)) {};
 
         std::vector<Vector3d> points() const;
 
+        /*!
+         * \brief Get all segments of the well path passing through this cell as (entry, exit) pairs.
+         *
+         * The first segment is the one defined by entry_point and exit_point; any further segments
+         * have been added with add_segment (e.g. by other branches of a multilateral well).
+         */
+        std::vector<std::pair<Vector3d, Vector3d>> segments() const;
+
+        /*!
+         * \brief Add another segment of the well path that passes through this cell.
+         */
+        void add_segment(const Vector3d &entry_point, const Vector3d &exit_point);
+
         Vector3d xvec() const;
         Vector3d yvec() const;
         Vector3d zvec() const;
@@ -57,6 +71,7 @@ namespace WellIndexCalculation {
     private:
         Vector3d entry_point_;
         Vector3d exit_point_;
+        std::vector<std::pair<Vector3d, Vector3d>> additional_segments_;
         double well_index_;
     };
 }
@@ -28,6 +28,8 @@
 #include "main.hpp"
 #include "wellindexcalculator.h"
 #include <Reservoir/grid/eclgrid.h>
+#include <memory>
+#include <stdexcept>
 
 using namespace std;
 
@@ -40,12 +42,67 @@ int main(int argc, const char *argv[]) {
     string gridpth = vm["grid"].as<string>();
     double wellbore_radius = vm["radius"].as<double>();
 
-    // Initialize the Grid and WellIndexCalculator objects
-    auto grid = new Reservoir::Grid::ECLGrid(gridpth);
-    
-    // Compute the well blocks
-    auto wic = WellIndexCalculator(grid);
-    auto well_blocks = wic.ComputeWellBlocks(heel, toe, wellbore_radius);
+    // The mainbore, and the laterals branching off it
+    auto well_tree = WellTree(heel, toe);
+    if (vm.count("lateral")) {
+        auto laterals = vm["lateral"].as<vector<double>>();
+        for (int i = 0; i < laterals.size(); i += 6) {
+            well_tree.AddLateral(Eigen::Vector3d(&laterals[i]), Eigen::Vector3d(&laterals[i+3]));
+        }
+    }
+
+    vector<IntersectedCell> well_blocks;
+    if (vm.count("compact")) { // Compute in a compact snapshot of the grid; the grid is only loaded to create it
+        string snapshot_path = vm["compact"].as<string>();
+        uint64_t grid_hash = WellBlockCache::HashGrid(gridpth, snapshot_path + ".gridhash");
+        unique_ptr<CompactGrid> compact_grid;
+        try {
+            compact_grid.reset(new CompactGrid(snapshot_path, grid_hash));
+        }
+        catch (const runtime_error &) { // Missing, or saved for another version of the grid
+            unique_ptr<Reservoir::Grid::ECLGrid> grid(new Reservoir::Grid::ECLGrid(gridpth));
+            compact_grid.reset(new CompactGrid(grid.get()));
+            compact_grid->Save(snapshot_path, grid_hash);
+        }
+        auto compact_wic = WellIndexCalculatorCore<CompactGrid>(compact_grid.get());
+        if (vm.count("lateral"))
+            well_blocks = compact_wic.ComputeWellBlocks(well_tree, wellbore_radius);
+        else
+            well_blocks = compact_wic.ComputeWellBlocks(heel, toe, wellbore_radius);
+    }
+    else {
+        // Initialize the Grid and WellIndexCalculator objects
+        auto grid = new Reservoir::Grid::ECLGrid(gridpth);
+        auto wic = WellIndexCalculator(grid);
+        uint64_t grid_hash = 0;
+        if (vm.count("cache") || vm.count("capture")) // The hashes are stored next to the cache or capture file
+            grid_hash = WellBlockCache::HashGrid(gridpth, (vm.count("cache") ? vm["cache"] : vm["capture"]).as<string>() + ".gridhash");
+        unique_ptr<WellBlockCache> cache;
+        if (vm.count("cache")) {
+            cache.reset(new WellBlockCache(vm["cache"].as<string>(), grid_hash,
+                                           (size_t)vm["cache-size"].as<int>() * 1024 * 1024));
+            wic.UseResultCache(cache.get());
+        }
+        unique_ptr<RequestCapture> capture;
+        if (vm.count("capture")) {
+            capture.reset(new RequestCapture(vm["capture"].as<string>(), grid_hash));
+            wic.UseRequestCapture(capture.get());
+        }
+
+        // Compute the well blocks
+        if (vm.count("lateral")) { // Multilateral well: the laterals branch off the heel-toe mainbore
+            well_blocks = wic.ComputeWellBlocks(well_tree, wellbore_radius);
+        }
+        else if (vm.count("approximate")) { // Approximate mode; the error estimate is written to stderr
+            auto approximate_blocks = wic.ComputeWellBlocksApproximate(heel, toe, wellbore_radius,
+                                                                       vm["approximate"].as<double>());
+            well_blocks = approximate_blocks.well_blocks;
+            cerr << "Estimated relative error: " << approximate_blocks.relative_error << endl;
+        }
+        else {
+            well_blocks = wic.ComputeWellBlocks(heel, toe, wellbore_radius);
+        }
+    }
 
     if (vm.count("compdat")) { // Print as a COMPDAT table if the --compdat/-c flag was given
         string well_name = vm["well-name"].as<string>();
@@ -91,10 +91,23 @@ po::variables_map createVariablesMap(int argc, const char **argv) {
              "Toe coordinates (x y z)")
             ("radius,r", po::value<double>(),
              "wellbore radius")
+            ("lateral,l", po::value<vector<double>>()->multitoken(),
+             "Lateral junction and toe coordinates (xj yj zj xt yt zt); may be repeated")
             ("compdat,c", po::value<int>()->implicit_value(0),
              "print in compdat format instead of CSV")
             ("well-name,w", po::value<string>(),
              "well name to be used when writing compdat")
+            ("approximate,a", po::value<double>(),
+             "use the approximate mode, with this largest relative error of the well index of each block")
+            ("compact", po::value<string>(),
+             "compute in a compact single precision snapshot of the grid at this path, creating it if necessary, "
+             "without loading the grid")
+            ("cache", po::value<string>(),
+             "path to a persistent result cache file, shared between runs")
+            ("cache-size", po::value<int>()->default_value(256),
+             "maximum size of a new result cache file (MB)")
+            ("capture", po::value<string>(),
+             "append the request to a capture file, for replay with WellIndexCalcReplay (single wells in exact mode only)")
             ;
 	
     // Process arguments to variable map
@@ -121,8 +134,16 @@ po::variables_map createVariablesMap(int argc, const char **argv) {
         assert(vm.count("well-name"));
     assert(vm["heel"].as<vector<double>>().size() == 3);
     assert(vm["toe"].as<vector<double>>().size() == 3);
+    if (vm.count("lateral"))
+        assert(vm["lateral"].as<vector<double>>().size() % 6 == 0);
     assert(boost::filesystem::exists(vm["grid"].as<string>()));
     assert(vm["radius"].as<double>() > 0);
+    if (vm.count("approximate"))
+        assert(vm["approximate"].as<double>() > 0 && !vm.count("lateral"));
+    if (vm.count("capture"))
+        assert(!vm.count("lateral") && !vm.count("approximate"));
+    if (vm.count("compact"))
+        assert(!vm.count("approximate") && !vm.count("cache") && !vm.count("capture"));
 
     return vm;
 }
@@ -0,0 +1,52 @@
+#include <stdexcept>
+#include "permeability_ensemble.h"
+
+namespace Reservoir {
+    namespace WellIndexCalculation {
+
+        namespace {
+            PermeabilityEnsemble::PermeabilityMatrix stack_realizations(const std::vector<std::vector<double>> &realizations,
+                                                                         int num_cells) {
+                PermeabilityEnsemble::PermeabilityMatrix stack(num_cells, realizations.size());
+                for (int r = 0; r < realizations.size(); ++r) {
+                    if (realizations[r].size() != num_cells)
+                        throw std::runtime_error("PermeabilityEnsemble: All realizations must have the same number of cells.");
+                    stack.col(r) = Map<const VectorXd>(realizations[r].data(), num_cells);
+                }
+                return stack;
+            }
+        }
+
+        PermeabilityEnsemble::PermeabilityEnsemble(const std::vector<std::vector<double>> &permx,
+                                                   const std::vector<std::vector<double>> &permy,
+                                                   const std::vector<std::vector<double>> &permz) {
+            if (permx.empty() || permx.size() != permy.size() || permx.size() != permz.size())
+                throw std::runtime_error("PermeabilityEnsemble: Each realization must have a permeability array for every direction.");
+
+            int num_cells = permx[0].size();
+            permx_ = stack_realizations(permx, num_cells);
+            permy_ = stack_realizations(permy, num_cells);
+            permz_ = stack_realizations(permz, num_cells);
+        }
+
+        int PermeabilityEnsemble::num_cells() const {
+            return permx_.rows();
+        }
+
+        int PermeabilityEnsemble::num_realizations() const {
+            return permx_.cols();
+        }
+
+        const PermeabilityEnsemble::PermeabilityMatrix &PermeabilityEnsemble::permx() const {
+            return permx_;
+        }
+
+        const PermeabilityEnsemble::PermeabilityMatrix &PermeabilityEnsemble::permy() const {
+            return permy_;
+        }
+
+        const PermeabilityEnsemble::PermeabilityMatrix &PermeabilityEnsemble::permz() const {
+            return permz_;
+        }
+    }
+}
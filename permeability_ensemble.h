@@ -0,0 +1,82 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef FIELDOPT_PERMEABILITYENSEMBLE_H
+#define FIELDOPT_PERMEABILITYENSEMBLE_H
+
+#include <vector>
+#include <Eigen/Core>
+#include "intersected_cell.h"
+
+namespace Reservoir {
+namespace WellIndexCalculation {
+    using namespace Eigen;
+
+    /*!
+     * \brief The PermeabilityEnsemble class holds the permeability fields of a set of geological
+     * realizations sharing the same grid geometry.
+     *
+     * The permeabilities are stored as (cells x realizations) matrices in row-major order, so
+     * that the values for a single cell in all realizations are contiguous.
+     */
+    class PermeabilityEnsemble {
+    public:
+        typedef Matrix<double, Dynamic, Dynamic, RowMajor> PermeabilityMatrix;
+
+        /*!
+         * \brief Create an ensemble from one permeability array per realization and direction.
+         *
+         * Each array should contain one value per cell in the grid, ordered by global index.
+         * \param permx The x-permeability arrays of all realizations.
+         * \param permy The y-permeability arrays of all realizations.
+         * \param permz The z-permeability arrays of all realizations.
+         */
+        PermeabilityEnsemble(const std::vector<std::vector<double>> &permx,
+                             const std::vector<std::vector<double>> &permy,
+                             const std::vector<std::vector<double>> &permz);
+
+        int num_cells() const;
+        int num_realizations() const;
+
+        const PermeabilityMatrix &permx() const;
+        const PermeabilityMatrix &permy() const;
+        const PermeabilityMatrix &permz() const;
+
+    private:
+        PermeabilityMatrix permx_;
+        PermeabilityMatrix permy_;
+        PermeabilityMatrix permz_;
+    };
+
+    /*!
+     * \brief The EnsembleWellBlocks struct holds the well blocks of a single well along with their
+     * well indices in every realization of an ensemble.
+     */
+    struct EnsembleWellBlocks {
+        std::vector<IntersectedCell> well_blocks; //!< The blocks penetrated by the well.
+        MatrixXd well_indices; //!< Well indices; one row per well block, one column per realization.
+    };
+}
+}
+
+#endif //FIELDOPT_PERMEABILITYENSEMBLE_H
@@ -0,0 +1,185 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+/*!
+ * @brief This file contains the main function for the capture replay executable.
+ *
+ * It re-runs the requests in a capture file (see RequestCapture) at full speed, and reports the throughput,
+ * the latency percentiles and any differences between the replayed and the captured results.
+ */
+
+#include "wellindexcalculator.h"
+#include <Reservoir/grid/eclgrid.h>
+#include <boost/program_options.hpp>
+#include <boost/format.hpp>
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <stdlib.h>
+
+namespace po = boost::program_options;
+using namespace Reservoir::WellIndexCalculation;
+using namespace std;
+
+po::variables_map createVariablesMap(int argc, const char **argv) {
+    po::options_description desc("FieldOpt options");
+    desc.add_options()
+            ("help", "print help message")
+            ("grid,g", po::value<string>(),
+             "path to model grid file (e.g. *.GRID)")
+            ("capture,c", po::value<string>(),
+             "path to the capture file to replay")
+            ("threads,n", po::value<int>()->default_value(1),
+             "number of threads replaying requests")
+            ;
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc, po::command_line_style::unix_style ^ po::command_line_style::allow_short), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        cout << "Usage: ./WellIndexCalcReplay --grid gridpath --capture capturepath [options]" << endl;
+        cout << desc << endl;
+        exit(EXIT_SUCCESS);
+    }
+
+    assert(vm.count("grid"));
+    assert(vm.count("capture"));
+    assert(vm["threads"].as<int>() > 0);
+    return vm;
+}
+
+double percentile(vector<double> sorted_values, double p) {
+    if (sorted_values.empty())
+        return 0.0;
+    int rank = (int)ceil(p / 100.0 * sorted_values.size());
+    return sorted_values[max(0, rank - 1)];
+}
+
+int main(int argc, const char *argv[]) {
+    auto vm = createVariablesMap(argc, argv);
+    string gridpth = vm["grid"].as<string>();
+    string capture_path = vm["capture"].as<string>();
+    int num_threads = vm["threads"].as<int>();
+
+    // Only replay the requests made in this grid
+    uint64_t grid_hash = WellBlockCache::HashGrid(gridpth, capture_path + ".gridhash");
+    auto captured = RequestCapture::Read(capture_path);
+    vector<CapturedRequest> requests;
+    for (auto &request : captured) {
+        if (request.grid_hash == grid_hash)
+            requests.push_back(request);
+    }
+    cout << boost::format("Replaying %d of %d captured requests on %d thread(s)")
+            % requests.size() % captured.size() % num_threads << endl;
+
+    // Every thread gets its own grid, as calls into a shared grid are serialized (see GridAccess)
+    vector<Reservoir::Grid::ECLGrid *> grids;
+    for (int t = 0; t < num_threads; ++t) {
+        grids.push_back(new Reservoir::Grid::ECLGrid(gridpth));
+    }
+
+    // A request that throws (e.g. a well outside the grid) is recorded as failed, and counted as a diff
+    vector<CapturedRequest> results(requests.size());
+    vector<string> errors(requests.size());
+    atomic<int> next_request(0);
+    auto replay = [&](int thread) {
+        auto wic = WellIndexCalculator(grids[thread]);
+        for (int i = next_request++; i < requests.size(); i = next_request++) {
+            auto heel = Eigen::Vector3d(requests[i].heel);
+            auto toe = Eigen::Vector3d(requests[i].toe);
+            auto start = chrono::steady_clock::now();
+            vector<IntersectedCell> well_blocks;
+            try {
+                well_blocks = wic.ComputeWellBlocks(heel, toe, requests[i].wellbore_radius);
+            }
+            catch (const exception &e) {
+                errors[i] = string("exception: ") + e.what();
+            }
+            catch (...) {
+                errors[i] = "unknown exception";
+            }
+            auto duration = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+            results[i] = RequestCapture::MakeRecord(grid_hash, heel, toe, requests[i].wellbore_radius,
+                                                    duration.count(), well_blocks);
+        }
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.push_back(thread(replay, t));
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    double wall_time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // Latencies (ms) and differences from the captured results
+    vector<double> replayed_latencies, captured_latencies;
+    int failures = 0;
+    int block_diffs = 0;
+    int well_index_diffs = 0;
+    double max_well_index_diff = 0.0;
+    for (int i = 0; i < requests.size(); ++i) {
+        replayed_latencies.push_back(results[i].duration * 1e-6);
+        captured_latencies.push_back(requests[i].duration * 1e-6);
+        if (!errors[i].empty()) {
+            if (failures++ < 10) {
+                cerr << boost::format("Request %d (heel %g %g %g, toe %g %g %g) failed: %s")
+                        % i % requests[i].heel[0] % requests[i].heel[1] % requests[i].heel[2]
+                        % requests[i].toe[0] % requests[i].toe[1] % requests[i].toe[2] % errors[i] << endl;
+            }
+            continue;
+        }
+        if (results[i].num_blocks != requests[i].num_blocks || results[i].blocks_hash != requests[i].blocks_hash)
+            block_diffs++;
+        double diff = fabs(results[i].total_well_index - requests[i].total_well_index) /
+                      max(fabs(requests[i].total_well_index), 1e-12);
+        if (diff > 1e-6)
+            well_index_diffs++;
+        max_well_index_diff = max(max_well_index_diff, diff);
+    }
+    sort(replayed_latencies.begin(), replayed_latencies.end());
+    sort(captured_latencies.begin(), captured_latencies.end());
+
+    cout << boost::format("Wall time:     %.3f s") % wall_time << endl;
+    cout << boost::format("Throughput:    %.1f wells/s") % (requests.size() / wall_time) << endl;
+    cout << "Latency (ms):  p50\tp90\tp99\tmax" << endl;
+    cout << boost::format("  replayed     %.3f\t%.3f\t%.3f\t%.3f")
+            % percentile(replayed_latencies, 50) % percentile(replayed_latencies, 90)
+            % percentile(replayed_latencies, 99) % percentile(replayed_latencies, 100) << endl;
+    cout << boost::format("  captured     %.3f\t%.3f\t%.3f\t%.3f")
+            % percentile(captured_latencies, 50) % percentile(captured_latencies, 90)
+            % percentile(captured_latencies, 99) % percentile(captured_latencies, 100) << endl;
+    cout << boost::format("Diffs:         %d failed, %d with different blocks, %d with different well indices (max rel. diff %g)")
+            % failures % block_diffs % well_index_diffs % max_well_index_diff << endl;
+
+    for (auto grid : grids) {
+        delete grid;
+    }
+    return failures + block_diffs + well_index_diffs > 0 ? 1 : 0;
+}
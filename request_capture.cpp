@@ -0,0 +1,77 @@
+#include <stdexcept>
+#include <chrono>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include "request_capture.h"
+
+namespace Reservoir {
+    namespace WellIndexCalculation {
+
+        namespace {
+            const uint32_t capture_magic = 0x52434957; // "WICR"
+            const uint32_t capture_version = 1;
+        }
+
+        RequestCapture::RequestCapture(std::string path, uint64_t grid_hash) {
+            grid_hash_ = grid_hash;
+            fd_ = open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+            if (fd_ < 0)
+                throw std::runtime_error("RequestCapture: Unable to open capture file " + path);
+        }
+
+        RequestCapture::~RequestCapture() {
+            close(fd_);
+        }
+
+        void RequestCapture::Capture(Vector3d heel, Vector3d toe, double wellbore_radius, int64_t duration,
+                                     const std::vector<IntersectedCell> &well_blocks) {
+            CapturedRequest record = MakeRecord(grid_hash_, heel, toe, wellbore_radius, duration, well_blocks);
+            if (write(fd_, &record, sizeof(CapturedRequest)) != sizeof(CapturedRequest))
+                throw std::runtime_error("RequestCapture: Unable to write to capture file.");
+        }
+
+        CapturedRequest RequestCapture::MakeRecord(uint64_t grid_hash, Vector3d heel, Vector3d toe,
+                                                   double wellbore_radius, int64_t duration,
+                                                   const std::vector<IntersectedCell> &well_blocks) {
+            CapturedRequest record = CapturedRequest();
+            record.magic = capture_magic;
+            record.version = capture_version;
+            record.grid_hash = grid_hash;
+            record.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+            record.duration = duration;
+            for (int i = 0; i < 3; ++i) {
+                record.heel[i] = heel[i];
+                record.toe[i] = toe[i];
+            }
+            record.wellbore_radius = wellbore_radius;
+            record.num_blocks = well_blocks.size();
+
+            record.blocks_hash = 14695981039346656037ULL; // FNV-1a
+            for (auto &block : well_blocks) {
+                uint32_t global_index = block.global_index();
+                for (int b = 0; b < 4; ++b) {
+                    record.blocks_hash = (record.blocks_hash ^ ((global_index >> (8 * b)) & 0xff)) * 1099511628211ULL;
+                }
+                record.total_well_index += block.well_index();
+            }
+            return record;
+        }
+
+        std::vector<CapturedRequest> RequestCapture::Read(const std::string &path) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+                throw std::runtime_error("RequestCapture: Unable to read capture file " + path);
+
+            std::vector<CapturedRequest> records;
+            CapturedRequest record;
+            while (file.read(reinterpret_cast<char *>(&record), sizeof(CapturedRequest))) {
+                if (record.magic != capture_magic || record.version != capture_version)
+                    throw std::runtime_error("RequestCapture: " + path + " is not a valid capture file.");
+                records.push_back(record);
+            }
+            return records;
+        }
+    }
+}
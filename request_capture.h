@@ -0,0 +1,101 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef FIELDOPT_REQUESTCAPTURE_H
+#define FIELDOPT_REQUESTCAPTURE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <Eigen/Core>
+#include "intersected_cell.h"
+
+namespace Reservoir {
+namespace WellIndexCalculation {
+    using namespace Eigen;
+
+    /*!
+     * \brief The CapturedRequest struct is a single ComputeWellBlocks request, as stored in a capture file.
+     *
+     * Along with the request itself, a summary of the result is stored, so that replays can be checked
+     * against it.
+     */
+    struct CapturedRequest {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t grid_hash;      //!< Content hash of the grid (see WellBlockCache::HashGrid).
+        int64_t timestamp;       //!< Time the request was made (ns since the epoch).
+        int64_t duration;        //!< Time spent computing the result (ns).
+        double heel[3];
+        double toe[3];
+        double wellbore_radius;
+        uint32_t num_blocks;     //!< Number of well blocks in the result.
+        uint32_t padding;
+        uint64_t blocks_hash;    //!< Hash of the global indices of the well blocks, in order.
+        double total_well_index; //!< Sum of the well indices of the well blocks.
+    };
+
+    /*!
+     * \brief The RequestCapture class appends ComputeWellBlocks requests to a compact binary capture file.
+     *
+     * Every request is written as one fixed size CapturedRequest record, in a single append, so several
+     * threads and processes may capture to the same file.
+     */
+    class RequestCapture {
+    public:
+        /*!
+         * \param path Path to the capture file. Requests are appended if it exists.
+         * \param grid_hash Content hash of the grid the requests are computed in.
+         */
+        RequestCapture(std::string path, uint64_t grid_hash);
+        ~RequestCapture();
+
+        RequestCapture(const RequestCapture &) = delete;
+        RequestCapture &operator=(const RequestCapture &) = delete;
+
+        /*!
+         * \brief Append a request and a summary of its result to the capture file.
+         * \param duration Time spent computing the result (ns).
+         */
+        void Capture(Vector3d heel, Vector3d toe, double wellbore_radius, int64_t duration,
+                     const std::vector<IntersectedCell> &well_blocks);
+
+        /*!
+         * \brief Create the record for a request and its result.
+         */
+        static CapturedRequest MakeRecord(uint64_t grid_hash, Vector3d heel, Vector3d toe, double wellbore_radius,
+                                          int64_t duration, const std::vector<IntersectedCell> &well_blocks);
+
+        /*!
+         * \brief Read all requests in a capture file.
+         */
+        static std::vector<CapturedRequest> Read(const std::string &path);
+
+    private:
+        int fd_;
+        uint64_t grid_hash_;
+    };
+}
+}
+
+#endif //FIELDOPT_REQUESTCAPTURE_H
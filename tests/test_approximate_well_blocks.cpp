@@ -0,0 +1,155 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include "Reservoir/grid/grid.h"
+#include "Reservoir/grid/eclgrid.h"
+#include "FieldOpt-WellIndexCalculator/wellindexcalculator.h"
+#include "FieldOpt-WellIndexCalculator/cell_geometry.h"
+
+using namespace Reservoir::Grid;
+using namespace Reservoir::WellIndexCalculation;
+
+namespace {
+
+    /*!
+     * \brief The stub grid with the corners moved by up to 2 m (of 24 m), so that the cell faces are warped.
+     */
+    class WarpedGrid : public ECLGrid {
+    public:
+        WarpedGrid(std::string file_path) : ECLGrid(file_path) {}
+
+        using ECLGrid::GetCell;
+        using ECLGrid::GetCellEnvelopingPoint;
+        Cell GetCell(int i, int j, int k) override {
+            Cell cell = ECLGrid::GetCell(i, j, k);
+            std::vector<Eigen::Vector3d> corners;
+            Eigen::Vector3d center = Eigen::Vector3d::Zero();
+            for (int c = 0; c < 8; ++c) {
+                int ni = i + c % 2, nj = j + (c / 2) % 2, nk = k + c / 4;
+                corners.push_back(cell.corners()[c] + 2.0 * Eigen::Vector3d(std::sin(0.5 * ni + 1.3 * nj + 2.1 * nk),
+                                                                            std::cos(0.9 * ni + 0.3 * nj + 1.7 * nk),
+                                                                            std::sin(0.8 * ni + 1.1 * nj)));
+                center += corners.back() / 8;
+            }
+            return Cell(cell.global_index(), cell.ijk_index(), cell.volume(), cell.porosity(),
+                        cell.permx(), cell.permy(), cell.permz(), center, corners);
+        }
+
+        // The cell that the point is least outside of, among the ones around the unwarped cell. The face planes
+        // of the warped cells leave small gaps along the edges, so points up to 1 m outside are accepted.
+        Cell GetCellEnvelopingPoint(double x, double y, double z) override {
+            Eigen::Vector3d point = Eigen::Vector3d(x, y, z);
+            int i = (int)std::floor(x / 24.0), j = (int)std::floor(y / 24.0);
+            Cell enveloping_cell;
+            double least_outside = INFINITY;
+            for (int ni = std::max(0, i - 1); ni <= std::min(59, i + 1); ++ni) {
+                for (int nj = std::max(0, j - 1); nj <= std::min(59, j + 1); ++nj) {
+                    Cell cell = GetCell(ni, nj, 0);
+                    double outside = CellGeometry(cell).distance_outside(point);
+                    if (outside < least_outside) {
+                        enveloping_cell = cell;
+                        least_outside = outside;
+                    }
+                }
+            }
+            if (least_outside > 1.0)
+                throw std::runtime_error("Point outside grid");
+            return enveloping_cell;
+        }
+    };
+
+    class ApproximateWellBlocksTest : public ::testing::Test {
+    protected:
+        ApproximateWellBlocksTest() {
+            grid_ = new ECLGrid(file_path_);
+            wic_ = WellIndexCalculator(grid_);
+        }
+
+        virtual ~ApproximateWellBlocksTest() {
+            delete grid_;
+        }
+
+        virtual void SetUp() {
+        }
+
+        virtual void TearDown() { }
+
+        Grid *grid_;
+        std::string file_path_ = "../examples/ADGPRS/5spot/ECL_5SPOT.EGRID";
+        WellIndexCalculator wic_;
+    };
+
+    TEST_F(ApproximateWellBlocksTest, approximate_within_estimated_error) {
+        WarpedGrid warped_grid(file_path_);
+        WellIndexCalculator wic(&warped_grid);
+
+        // Along a row of cells, crossing the warped faces away from their edges, where exact mode is well-defined
+        Eigen::Vector3d heel = Eigen::Vector3d(10.0, 128.0, 1708);
+        Eigen::Vector3d toe = Eigen::Vector3d(1420.0, 136.0, 1716);
+        auto exact_blocks = wic.ComputeWellBlocks(heel, toe, 0.190);
+
+        double previous_error = INFINITY;
+        for (double tolerance : {0.5, 0.1, 0.01, 1e-6}) {
+            auto approximate = wic.ComputeWellBlocksApproximate(heel, toe, 0.190, tolerance);
+            ASSERT_EQ(approximate.well_blocks.size(), approximate.relative_errors.size());
+            ASSERT_EQ(exact_blocks.size(), approximate.well_blocks.size());
+            if (tolerance > 0.01) // The faces are warped, so the boundaries are uncertain
+                EXPECT_GT(approximate.relative_error, 0.0);
+
+            // Every block should be the exact one, with a well index within its error estimate
+            double error = 0.0;
+            for (int i = 0; i < exact_blocks.size(); ++i) {
+                auto &block = approximate.well_blocks[i];
+                EXPECT_EQ(exact_blocks[i].global_index(), block.global_index());
+                EXPECT_LE(approximate.relative_errors[i], tolerance + 10e-10);
+                EXPECT_LE(std::abs(block.well_index() - exact_blocks[i].well_index()),
+                          approximate.relative_errors[i] * block.well_index() + 10e-10);
+                error += (block.exit_point() - exact_blocks[i].exit_point()).norm();
+            }
+
+            // A smaller tolerance finds more of the boundaries between the blocks as in exact mode, and should
+            // never move one further from the exact one
+            EXPECT_LE(error, previous_error + 10e-10);
+            previous_error = error;
+        }
+        EXPECT_LT(previous_error, 10e-10);
+    }
+
+    TEST_F(ApproximateWellBlocksTest, planar_grid_gives_exact_blocks) {
+        // The cell faces are planar, so stepping between neighbours finds the same blocks as exact mode
+        Eigen::Vector3d heel = Eigen::Vector3d(5.0, 5.0, 1705);
+        Eigen::Vector3d toe = Eigen::Vector3d(1400.0, 1300.0, 1720);
+        auto exact_blocks = wic_.ComputeWellBlocks(heel, toe, 0.190);
+        auto approximate = wic_.ComputeWellBlocksApproximate(heel, toe, 0.190, 0.1);
+        ASSERT_EQ(exact_blocks.size(), approximate.well_blocks.size());
+        for (int i = 0; i < exact_blocks.size(); ++i) {
+            EXPECT_EQ(exact_blocks[i].global_index(), approximate.well_blocks[i].global_index());
+            EXPECT_NEAR(exact_blocks[i].well_index(), approximate.well_blocks[i].well_index(),
+                        10e-6 * exact_blocks[i].well_index());
+        }
+        EXPECT_LE(approximate.relative_error, 10e-6);
+    }
+
+}
@@ -0,0 +1,243 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <future>
+#include <thread>
+#include "Reservoir/grid/grid.h"
+#include "Reservoir/grid/eclgrid.h"
+#include "FieldOpt-WellIndexCalculator/wellindexcalculator.h"
+#include "FieldOpt-WellIndexCalculator/executor.h"
+
+using namespace Reservoir::Grid;
+using namespace Reservoir::WellIndexCalculation;
+
+namespace {
+
+    class AsyncWellBlocksTest : public ::testing::Test {
+    protected:
+        AsyncWellBlocksTest() {
+            grid_ = new ECLGrid(file_path_);
+            wic_ = WellIndexCalculator(grid_);
+        }
+
+        virtual ~AsyncWellBlocksTest() {
+            delete grid_;
+        }
+
+        virtual void SetUp() {
+        }
+
+        virtual void TearDown() { }
+
+        Grid *grid_;
+        std::string file_path_ = "../examples/ADGPRS/5spot/ECL_5SPOT.EGRID";
+        WellIndexCalculator wic_;
+    };
+
+    TEST_F(AsyncWellBlocksTest, same_result_as_synchronous) {
+        auto heel = Eigen::Vector3d(0.05, 0.00, 1712);
+        auto toe = Eigen::Vector3d(1440.0, 1400.0, 1712);
+        auto future = wic_.ComputeWellBlocksAsync(heel, toe, 0.190);
+        auto blocks = wic_.ComputeWellBlocks(heel, toe, 0.190);
+
+        auto async_blocks = future.get();
+        ASSERT_EQ(blocks.size(), async_blocks.size());
+        for (int i = 0; i < blocks.size(); ++i) {
+            EXPECT_EQ(blocks[i].global_index(), async_blocks[i].global_index());
+            EXPECT_DOUBLE_EQ(blocks[i].well_index(), async_blocks[i].well_index());
+        }
+    }
+
+    TEST_F(AsyncWellBlocksTest, cancelled_computations_throw) {
+        auto heel = Eigen::Vector3d(0.05, 0.00, 1712);
+        auto toe = Eigen::Vector3d(1440.0, 1400.0, 1712);
+
+        CancellationToken token;
+        token.Cancel();
+        auto cancelled = wic_.ComputeWellBlocksAsync(heel, toe, 0.190, token);
+        EXPECT_THROW(cancelled.get(), WellIndexCalculationCancelled);
+
+        auto expired = wic_.ComputeWellBlocksAsync(heel, toe, 0.190, CancellationToken(),
+                                                   std::chrono::steady_clock::now() - std::chrono::seconds(1));
+        EXPECT_THROW(expired.get(), WellIndexCalculationCancelled);
+
+        // The synchronous interface honours the token as well
+        wic_.UseCancellationToken(token);
+        EXPECT_THROW(wic_.ComputeWellBlocks(heel, toe, 0.190), WellIndexCalculationCancelled);
+    }
+
+    /*!
+     * \brief Grid counting the cells located in it, and the largest number of threads calling it at once.
+     */
+    class CountingGrid : public ECLGrid {
+    public:
+        CountingGrid(std::string file_path) : ECLGrid(file_path) {}
+
+        Cell GetCell(int global_index) override {
+            Call call(this);
+            return ECLGrid::GetCell(global_index);
+        }
+
+        Cell GetCell(int i, int j, int k) override {
+            Call call(this);
+            return ECLGrid::GetCell(i, j, k);
+        }
+
+        Cell GetCellEnvelopingPoint(double x, double y, double z) override {
+            Call call(this);
+            num_located++;
+            return ECLGrid::GetCellEnvelopingPoint(x, y, z);
+        }
+
+        Cell GetCellEnvelopingPoint(Eigen::Vector3d xyz) override {
+            return GetCellEnvelopingPoint(xyz.x(), xyz.y(), xyz.z());
+        }
+
+        std::atomic<int> num_located{0};
+        std::atomic<int> max_concurrent_calls{0};
+
+    private:
+        std::atomic<int> concurrent_calls_{0};
+
+        // Counts the outermost call on each thread, as the grid may call itself
+        struct Call {
+            CountingGrid *grid;
+            Call(CountingGrid *grid) : grid(grid) {
+                if (depth()++ > 0)
+                    return;
+                int calls = ++grid->concurrent_calls_;
+                for (int max = grid->max_concurrent_calls; calls > max
+                     && !grid->max_concurrent_calls.compare_exchange_weak(max, calls); ) { }
+                std::this_thread::yield(); // Give other threads a chance to enter
+            }
+            ~Call() {
+                if (--depth() == 0)
+                    grid->concurrent_calls_--;
+            }
+            static int &depth() {
+                thread_local int depth = 0;
+                return depth;
+            }
+        };
+    };
+
+    TEST_F(AsyncWellBlocksTest, cancel_queued_computations) {
+        auto heel = Eigen::Vector3d(0.05, 0.00, 1712);
+        auto toe = Eigen::Vector3d(1440.0, 1400.0, 1712);
+        CountingGrid counting_grid(file_path_);
+        auto wic = WellIndexCalculator(&counting_grid);
+
+        // Keep every worker of the shared executor busy until the gate opens
+        Executor &executor = Executor::Shared();
+        std::promise<void> gate;
+        std::shared_future<void> gate_opened = gate.get_future().share();
+        for (int t = 0; t < executor.num_threads(); ++t) {
+            executor.Submit([gate_opened]() { gate_opened.wait(); });
+        }
+
+        // Queue computations behind the gated tasks and cancel them before any of them can start
+        CancellationToken token;
+        std::vector<std::future<std::vector<IntersectedCell>>> futures;
+        for (int i = 0; i < 2 * executor.num_threads(); ++i) {
+            futures.push_back(wic.ComputeWellBlocksAsync(heel, toe, 0.190, token));
+        }
+        token.Cancel();
+        gate.set_value();
+
+        for (auto &future : futures) {
+            EXPECT_THROW(future.get(), WellIndexCalculationCancelled);
+        }
+        EXPECT_EQ(0, counting_grid.num_located); // None of them touched the grid
+    }
+
+    TEST_F(AsyncWellBlocksTest, calculators_share_grid) {
+        auto heel = Eigen::Vector3d(0.05, 0.00, 1712);
+        auto toe = Eigen::Vector3d(1440.0, 1400.0, 1712);
+        CountingGrid counting_grid(file_path_);
+        auto wic = WellIndexCalculator(&counting_grid);
+        auto blocks = wic.ComputeWellBlocks(heel, toe, 0.190);
+
+        // Asynchronous computations, a multilateral well and a coefficient table, all reading the grid at once
+        std::vector<std::future<std::vector<IntersectedCell>>> futures;
+        for (int i = 0; i < 2 * Executor::Shared().num_threads(); ++i) {
+            futures.push_back(wic.ComputeWellBlocksAsync(heel, toe, 0.190));
+        }
+        auto well_tree = WellTree(heel, toe);
+        well_tree.AddLateral(Eigen::Vector3d(720, 700, 1712), Eigen::Vector3d(100, 1400, 1712));
+        well_tree.AddLateral(Eigen::Vector3d(360, 350, 1712), Eigen::Vector3d(1400, 100, 1712));
+        auto multilateral_blocks = wic.ComputeWellBlocks(well_tree, 0.190);
+        WellIndexCoefficientTable table(&counting_grid);
+
+        for (auto &future : futures) {
+            auto async_blocks = future.get();
+            ASSERT_EQ(blocks.size(), async_blocks.size());
+            for (int i = 0; i < blocks.size(); ++i) {
+                EXPECT_EQ(blocks[i].global_index(), async_blocks[i].global_index());
+            }
+        }
+        EXPECT_FALSE(multilateral_blocks.empty());
+        EXPECT_EQ(1, counting_grid.max_concurrent_calls);
+    }
+
+    TEST(ExecutorTest, queued_tasks_run_before_stopping) {
+        std::atomic<int> num_run{0};
+        {
+            Executor executor(1);
+            executor.Submit([]() { std::this_thread::sleep_for(std::chrono::milliseconds(20)); });
+            for (int i = 0; i < 4; ++i) {
+                executor.Submit([&num_run]() { num_run++; });
+            }
+        }
+        EXPECT_EQ(4, num_run);
+    }
+
+    TEST(ExecutorTest, parallel_for_runs_every_task) {
+        Executor executor(2);
+        std::vector<std::atomic<int>> runs(100);
+        executor.ParallelFor(runs.size(), [&runs](int i) { runs[i]++; });
+        for (auto &run : runs) {
+            EXPECT_EQ(1, run);
+        }
+
+        // Nested in a task while the other worker is busy, the calling worker does the work itself
+        std::promise<void> gate;
+        std::shared_future<void> gate_opened = gate.get_future().share();
+        executor.Submit([gate_opened]() { gate_opened.wait(); });
+        std::promise<int> nested_sum;
+        auto nested_result = nested_sum.get_future();
+        executor.Submit([&executor, &nested_sum]() {
+            std::atomic<int> sum{0};
+            executor.ParallelFor(10, [&sum](int i) { sum += i; });
+            nested_sum.set_value(sum);
+        });
+        EXPECT_EQ(45, nested_result.get());
+        gate.set_value();
+
+        EXPECT_THROW(executor.ParallelFor(10, [](int i) {
+            if (i == 3)
+                throw std::runtime_error("task failed");
+        }), std::runtime_error);
+    }
+}
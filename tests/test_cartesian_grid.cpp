@@ -0,0 +1,122 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include "Reservoir/grid/grid.h"
+#include "Reservoir/grid/eclgrid.h"
+#include "FieldOpt-WellIndexCalculator/wellindexcalculator.h"
+#include "FieldOpt-WellIndexCalculator/cartesian_grid.h"
+
+using namespace Reservoir::Grid;
+using namespace Reservoir::WellIndexCalculation;
+
+namespace {
+
+    class CartesianGridTest : public ::testing::Test {
+    protected:
+        CartesianGridTest() {
+            grid_ = new ECLGrid(file_path_);
+            wic_ = WellIndexCalculator(grid_);
+
+            // A Cartesian grid with the same geometry (24 x 24 x 24 cells with the top at 1700) and permeabilities
+            auto dims = grid_->Dimensions();
+            std::vector<double> permx, permy, permz;
+            for (int i = 0; i < dims.nx * dims.ny * dims.nz; ++i) {
+                auto cell = grid_->GetCell(i);
+                permx.push_back(cell.permx());
+                permy.push_back(cell.permy());
+                permz.push_back(cell.permz());
+            }
+            cartesian_grid_ = new CartesianGrid(Eigen::Vector3d(0, 0, 1700), Eigen::Vector3d(24, 24, 24),
+                                                dims.nx, dims.ny, dims.nz, permx, permy, permz);
+        }
+
+        virtual ~CartesianGridTest() {
+            delete grid_;
+            delete cartesian_grid_;
+        }
+
+        virtual void SetUp() {
+        }
+
+        virtual void TearDown() { }
+
+        Grid *grid_;
+        std::string file_path_ = "../examples/ADGPRS/5spot/ECL_5SPOT.EGRID";
+        WellIndexCalculator wic_;
+        CartesianGrid *cartesian_grid_;
+    };
+
+    TEST_F(CartesianGridTest, cells_match_grid) {
+        for (int i : {0, 1, 61, 3599}) {
+            auto cell = grid_->GetCell(i);
+            auto cartesian_cell = cartesian_grid_->GetCell(i);
+            EXPECT_EQ(cell.global_index(), cartesian_cell.global_index());
+            EXPECT_EQ(cell.ijk_index().i(), cartesian_cell.ijk_index().i());
+            EXPECT_EQ(cell.ijk_index().j(), cartesian_cell.ijk_index().j());
+            EXPECT_EQ(cell.ijk_index().k(), cartesian_cell.ijk_index().k());
+            for (int c = 0; c < 8; ++c) {
+                EXPECT_LT((cell.corners()[c] - cartesian_cell.corners()[c]).norm(), 10e-6);
+            }
+        }
+        EXPECT_EQ(0, cartesian_grid_->GetCellEnvelopingPoint(Eigen::Vector3d(12, 12, 1712)).global_index());
+        EXPECT_EQ(1, cartesian_grid_->GetCellEnvelopingPoint(Eigen::Vector3d(24, 12, 1712)).global_index());
+        EXPECT_THROW(cartesian_grid_->GetCellEnvelopingPoint(Eigen::Vector3d(12, 12, 1699)), std::runtime_error);
+    }
+
+    TEST_F(CartesianGridTest, specialized_calculator_matches_wrapper) {
+        auto cartesian_wic = WellIndexCalculatorCore<CartesianGrid>(cartesian_grid_);
+
+        Eigen::Vector3d heel = Eigen::Vector3d(0.05, 0.00, 1712);
+        Eigen::Vector3d toe = Eigen::Vector3d(1440.0, 1400.0, 1712);
+        auto blocks = wic_.ComputeWellBlocks(heel, toe, 0.190);
+        auto cartesian_blocks = cartesian_wic.ComputeWellBlocks(heel, toe, 0.190);
+
+        ASSERT_EQ(blocks.size(), cartesian_blocks.size());
+        for (int i = 0; i < blocks.size(); ++i) {
+            EXPECT_EQ(blocks[i].global_index(), cartesian_blocks[i].global_index());
+            EXPECT_NEAR(blocks[i].well_index(), cartesian_blocks[i].well_index(), 10e-6);
+        }
+    }
+
+    TEST_F(CartesianGridTest, cell_geometry_matches_cell) {
+        CellGeometry cartesian_cell;
+        ASSERT_TRUE(cartesian_grid_->GetCellGeometry(1, 2, 0, cartesian_cell));
+        EXPECT_FALSE(cartesian_grid_->GetCellGeometry(60, 2, 0, cartesian_cell));
+        ASSERT_TRUE(cartesian_grid_->GetCellGeometry(1, 2, 0, cartesian_cell));
+
+        // The axis-aligned faces of the Cartesian grid are the same as the ones computed from the corners
+        CellGeometry cell(grid_->GetCell(1, 2, 0));
+        cell.SetFacesFromCorners();
+        EXPECT_EQ(cell.global_index, cartesian_cell.global_index);
+        for (int f = 0; f < 6; ++f) {
+            EXPECT_LT((cell.face_normals[f] - cartesian_cell.face_normals[f]).norm(), 10e-10);
+            EXPECT_NEAR(cell.face_normals[f].dot(cell.face_points[f]),
+                        cartesian_cell.face_normals[f].dot(cartesian_cell.face_points[f]), 10e-8);
+            EXPECT_DOUBLE_EQ(0.0, cell.face_warp(f));
+        }
+        EXPECT_TRUE(cartesian_cell.Contains(cell.center, 0.0));
+        EXPECT_FALSE(cartesian_cell.Contains(cell.center + Eigen::Vector3d(24, 0, 0), 0.0));
+    }
+
+}
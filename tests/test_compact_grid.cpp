@@ -0,0 +1,160 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "Reservoir/grid/grid.h"
+#include "Reservoir/grid/eclgrid.h"
+#include "FieldOpt-WellIndexCalculator/wellindexcalculator.h"
+#include "FieldOpt-WellIndexCalculator/compact_grid.h"
+
+using namespace Reservoir::Grid;
+using namespace Reservoir::WellIndexCalculation;
+
+namespace {
+
+    class CompactGridTest : public ::testing::Test {
+    protected:
+        CompactGridTest() {
+            grid_ = new ECLGrid(file_path_);
+            wic_ = WellIndexCalculator(grid_);
+        }
+
+        virtual ~CompactGridTest() {
+            delete grid_;
+        }
+
+        virtual void SetUp() {
+        }
+
+        virtual void TearDown() { }
+
+        Grid *grid_;
+        std::string file_path_ = "../examples/ADGPRS/5spot/ECL_5SPOT.EGRID";
+        WellIndexCalculator wic_;
+    };
+
+    TEST_F(CompactGridTest, well_indices_within_tolerance) {
+        auto compact_grid = CompactGrid(grid_);
+        auto dims = grid_->Dimensions();
+        // The compact grid, including the point location buckets, is smaller than the double precision corners alone
+        EXPECT_LT(compact_grid.memory_usage(), 8 * sizeof(Eigen::Vector3d) * dims.nx * dims.ny * dims.nz);
+
+        auto cell = grid_->GetCell(61);
+        auto compact_cell = compact_grid.GetCell(61);
+        for (int c = 0; c < 8; ++c) {
+            EXPECT_LT((cell.corners()[c] - compact_cell.corners()[c]).norm(), 10e-4);
+        }
+        EXPECT_EQ(61, compact_grid.GetCellEnvelopingPoint(cell.center()).global_index());
+
+        // The well indices computed in the compact grid should be within 1e-4 of the full precision ones
+        auto compact_wic = WellIndexCalculatorCore<CompactGrid>(&compact_grid);
+        std::vector<std::pair<Eigen::Vector3d, Eigen::Vector3d>> wells = {
+                {Eigen::Vector3d(0.05, 0.00, 1712), Eigen::Vector3d(1440.0, 1400.0, 1712)},
+                {Eigen::Vector3d(0, 0, 1702), Eigen::Vector3d(450, 830, 1716)},
+                {Eigen::Vector3d(12, 12, 1700), Eigen::Vector3d(12, 12, 1724)}
+        };
+        for (auto well : wells) {
+            auto blocks = wic_.ComputeWellBlocks(well.first, well.second, 0.190);
+            auto compact_blocks = compact_wic.ComputeWellBlocks(well.first, well.second, 0.190);
+            ASSERT_EQ(blocks.size(), compact_blocks.size());
+            for (int i = 0; i < blocks.size(); ++i) {
+                EXPECT_EQ(blocks[i].global_index(), compact_blocks[i].global_index());
+                EXPECT_NEAR(blocks[i].well_index(), compact_blocks[i].well_index(), 1e-4 * blocks[i].well_index());
+            }
+        }
+    }
+
+    TEST_F(CompactGridTest, calculator_uses_compact_grid) {
+        auto compact_grid = CompactGrid(grid_);
+        Eigen::Vector3d heel = Eigen::Vector3d(0, 0, 1702);
+        Eigen::Vector3d toe = Eigen::Vector3d(450, 830, 1716);
+        auto blocks = wic_.ComputeWellBlocks(heel, toe, 0.190);
+
+        wic_.UseCompactGrid(&compact_grid);
+        auto compact_blocks = wic_.ComputeWellBlocks(heel, toe, 0.190);
+        ASSERT_EQ(blocks.size(), compact_blocks.size());
+        for (int i = 0; i < blocks.size(); ++i) {
+            EXPECT_EQ(blocks[i].global_index(), compact_blocks[i].global_index());
+            EXPECT_NEAR(blocks[i].well_index(), compact_blocks[i].well_index(), 1e-4 * blocks[i].well_index());
+        }
+    }
+
+    TEST_F(CompactGridTest, well_tree_on_compact_grid) {
+        auto compact_grid = CompactGrid(grid_);
+        auto tree = WellTree(Eigen::Vector3d(12, 12, 1712), Eigen::Vector3d(590, 12, 1712));
+        tree.AddLateral(Eigen::Vector3d(200, 12, 1712), Eigen::Vector3d(200, 400, 1712));
+        tree.AddLateral(Eigen::Vector3d(400, 12, 1712), Eigen::Vector3d(400, 400, 1712));
+
+        // The branches are computed concurrently on the compact grid, and merged as on the full grid
+        auto blocks = wic_.ComputeWellBlocks(tree, 0.190);
+        auto compact_blocks = WellIndexCalculatorCore<CompactGrid>(&compact_grid).ComputeWellBlocks(tree, 0.190);
+        ASSERT_EQ(blocks.size(), compact_blocks.size());
+        for (int i = 0; i < blocks.size(); ++i) {
+            EXPECT_EQ(blocks[i].global_index(), compact_blocks[i].global_index());
+            EXPECT_NEAR(blocks[i].well_index(), compact_blocks[i].well_index(), 1e-4 * blocks[i].well_index());
+        }
+    }
+
+    TEST_F(CompactGridTest, snapshot_replaces_grid) {
+        std::string snapshot_path = "test_compact_grid.bin";
+        CompactGrid(grid_).Save(snapshot_path, 42);
+        EXPECT_THROW(CompactGrid(snapshot_path, 43), std::runtime_error);
+        EXPECT_THROW(CompactGrid(snapshot_path + ".missing", 42), std::runtime_error);
+
+        // The loaded compact grid gives the same results as the one it was saved from, without the grid
+        auto compact_grid = CompactGrid(grid_);
+        auto loaded_grid = CompactGrid(snapshot_path, 42);
+        std::remove(snapshot_path.c_str());
+        EXPECT_EQ(compact_grid.memory_usage(), loaded_grid.memory_usage());
+        Eigen::Vector3d heel = Eigen::Vector3d(0, 0, 1702);
+        Eigen::Vector3d toe = Eigen::Vector3d(450, 830, 1716);
+        auto blocks = WellIndexCalculatorCore<CompactGrid>(&compact_grid).ComputeWellBlocks(heel, toe, 0.190);
+        auto loaded_blocks = WellIndexCalculatorCore<CompactGrid>(&loaded_grid).ComputeWellBlocks(heel, toe, 0.190);
+        ASSERT_EQ(blocks.size(), loaded_blocks.size());
+        for (int i = 0; i < blocks.size(); ++i) {
+            EXPECT_EQ(blocks[i].global_index(), loaded_blocks[i].global_index());
+            EXPECT_DOUBLE_EQ(blocks[i].well_index(), loaded_blocks[i].well_index());
+        }
+    }
+
+    TEST_F(CompactGridTest, compact_results_are_not_cached) {
+        std::string cache_path = "test_compact_grid_cache.bin";
+        auto compact_grid = CompactGrid(grid_);
+        WellBlockCache cache(cache_path, 42);
+        wic_.UseResultCache(&cache);
+        wic_.UseCompactGrid(&compact_grid);
+
+        Eigen::Vector3d heel = Eigen::Vector3d(0, 0, 1702);
+        Eigen::Vector3d toe = Eigen::Vector3d(450, 830, 1716);
+        wic_.ComputeWellBlocks(heel, toe, 0.190);
+        std::vector<IntersectedCell> cached_blocks;
+        EXPECT_FALSE(cache.Lookup(heel, toe, 0.190, grid_, cached_blocks));
+
+        wic_.UseCompactGrid(nullptr);
+        wic_.ComputeWellBlocks(heel, toe, 0.190);
+        EXPECT_TRUE(cache.Lookup(heel, toe, 0.190, grid_, cached_blocks));
+        std::remove(cache_path.c_str());
+    }
+
+}
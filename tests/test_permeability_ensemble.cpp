@@ -0,0 +1,98 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include "Reservoir/grid/grid.h"
+#include "Reservoir/grid/eclgrid.h"
+#include "FieldOpt-WellIndexCalculator/wellindexcalculator.h"
+
+using namespace Reservoir::Grid;
+using namespace Reservoir::WellIndexCalculation;
+
+namespace {
+
+    class PermeabilityEnsembleTest : public ::testing::Test {
+    protected:
+        PermeabilityEnsembleTest() {
+            grid_ = new ECLGrid(file_path_);
+            wic_ = WellIndexCalculator(grid_);
+        }
+
+        virtual ~PermeabilityEnsembleTest() {
+            delete grid_;
+        }
+
+        virtual void SetUp() {
+        }
+
+        virtual void TearDown() { }
+
+        Grid *grid_;
+        std::string file_path_ = "../examples/ADGPRS/5spot/ECL_5SPOT.EGRID";
+        WellIndexCalculator wic_;
+    };
+
+    TEST_F(PermeabilityEnsembleTest, ensemble_matches_single_realizations) {
+        auto dims = grid_->Dimensions();
+        int num_cells = dims.nx * dims.ny * dims.nz;
+
+        // Realization 0 uses the permeabilities in the grid; realization 1 is scaled by 2 and realization 2
+        // is anisotropic.
+        std::vector<std::vector<double>> permx(3, std::vector<double>(num_cells));
+        std::vector<std::vector<double>> permy(3, std::vector<double>(num_cells));
+        std::vector<std::vector<double>> permz(3, std::vector<double>(num_cells));
+        for (int i = 0; i < num_cells; ++i) {
+            auto cell = grid_->GetCell(i);
+            permx[0][i] = cell.permx(); permy[0][i] = cell.permy(); permz[0][i] = cell.permz();
+            permx[1][i] = 2 * cell.permx(); permy[1][i] = 2 * cell.permy(); permz[1][i] = 2 * cell.permz();
+            permx[2][i] = cell.permx(); permy[2][i] = 0.5 * cell.permy(); permz[2][i] = 0.1 * cell.permz();
+        }
+        auto ensemble = PermeabilityEnsemble(permx, permy, permz);
+        EXPECT_EQ(3, ensemble.num_realizations());
+        EXPECT_EQ(num_cells, ensemble.num_cells());
+
+        Eigen::Vector3d heel = Eigen::Vector3d(0, 0, 1702);
+        Eigen::Vector3d toe = Eigen::Vector3d(440, 840, 1720);
+        auto ensemble_blocks = wic_.ComputeWellBlocks(heel, toe, 0.190, ensemble);
+        ASSERT_EQ(ensemble_blocks.well_blocks.size(), ensemble_blocks.well_indices.rows());
+        ASSERT_EQ(3, ensemble_blocks.well_indices.cols());
+
+        for (int i = 0; i < ensemble_blocks.well_blocks.size(); ++i) {
+            auto icell = ensemble_blocks.well_blocks[i];
+            double wi = icell.well_index();
+            EXPECT_NEAR(wi, ensemble_blocks.well_indices(i, 0), 10e-10);
+            EXPECT_NEAR(2 * wi, ensemble_blocks.well_indices(i, 1), 10e-10);
+
+            // Compare the anisotropic realization to a scalar computation with the same permeabilities
+            Eigen::Vector3d L = wic_.projected_lengths(icell);
+            double kx = permx[2][icell.global_index()];
+            double ky = permy[2][icell.global_index()];
+            double kz = permz[2][icell.global_index()];
+            double wi_x = wic_.dir_well_index(L.x(), icell.dy(), icell.dz(), ky, kz);
+            double wi_y = wic_.dir_well_index(L.y(), icell.dx(), icell.dz(), kx, kz);
+            double wi_z = wic_.dir_well_index(L.z(), icell.dx(), icell.dy(), kx, ky);
+            EXPECT_NEAR(sqrt(wi_x * wi_x + wi_y * wi_y + wi_z * wi_z), ensemble_blocks.well_indices(i, 2), 10e-10);
+        }
+    }
+
+}
@@ -0,0 +1,90 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "Reservoir/grid/grid.h"
+#include "Reservoir/grid/eclgrid.h"
+#include "FieldOpt-WellIndexCalculator/wellindexcalculator.h"
+
+using namespace Reservoir::Grid;
+using namespace Reservoir::WellIndexCalculation;
+
+namespace {
+
+    class RequestCaptureTest : public ::testing::Test {
+    protected:
+        RequestCaptureTest() {
+            grid_ = new ECLGrid(file_path_);
+            wic_ = WellIndexCalculator(grid_);
+        }
+
+        virtual ~RequestCaptureTest() {
+            delete grid_;
+            std::remove(capture_path_.c_str());
+        }
+
+        virtual void SetUp() {
+        }
+
+        virtual void TearDown() { }
+
+        Grid *grid_;
+        std::string file_path_ = "../examples/ADGPRS/5spot/ECL_5SPOT.EGRID";
+        WellIndexCalculator wic_;
+        std::string capture_path_ = "test_request_capture.bin";
+    };
+
+    TEST_F(RequestCaptureTest, captured_requests_are_read_back) {
+        std::vector<Eigen::Vector3d> toes = {Eigen::Vector3d(100, 12, 1712), Eigen::Vector3d(450, 830, 1716)};
+        Eigen::Vector3d heel = Eigen::Vector3d(12, 12, 1712);
+        std::vector<std::vector<IntersectedCell>> results;
+        {
+            RequestCapture capture(capture_path_, 42);
+            wic_.UseRequestCapture(&capture);
+            for (auto toe : toes) {
+                results.push_back(wic_.ComputeWellBlocks(heel, toe, 0.190));
+            }
+            wic_.UseRequestCapture(nullptr);
+        }
+
+        auto requests = RequestCapture::Read(capture_path_);
+        ASSERT_EQ(toes.size(), requests.size());
+        for (int i = 0; i < requests.size(); ++i) {
+            EXPECT_EQ(42, requests[i].grid_hash);
+            EXPECT_EQ(heel, Eigen::Vector3d(requests[i].heel));
+            EXPECT_EQ(toes[i], Eigen::Vector3d(requests[i].toe));
+            EXPECT_EQ(0.190, requests[i].wellbore_radius);
+            EXPECT_EQ(results[i].size(), requests[i].num_blocks);
+            EXPECT_GT(requests[i].duration, 0);
+
+            // Replaying the request gives the same summary
+            auto replayed = RequestCapture::MakeRecord(42, heel, toes[i], 0.190, 0,
+                                                       wic_.ComputeWellBlocks(heel, toes[i], 0.190));
+            EXPECT_EQ(requests[i].blocks_hash, replayed.blocks_hash);
+            EXPECT_DOUBLE_EQ(requests[i].total_well_index, replayed.total_well_index);
+        }
+        EXPECT_LE(requests[0].timestamp, requests[1].timestamp);
+    }
+
+}
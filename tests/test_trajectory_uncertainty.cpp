@@ -0,0 +1,129 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include "Reservoir/grid/grid.h"
+#include "Reservoir/grid/eclgrid.h"
+#include "FieldOpt-WellIndexCalculator/wellindexcalculator.h"
+#include "FieldOpt-WellIndexCalculator/trajectory_uncertainty.h"
+
+using namespace Reservoir::Grid;
+using namespace Reservoir::WellIndexCalculation;
+
+namespace {
+
+    class TrajectoryUncertaintyTest : public ::testing::Test {
+    protected:
+        TrajectoryUncertaintyTest() {
+            grid_ = new ECLGrid(file_path_);
+            wic_ = WellIndexCalculator(grid_);
+        }
+
+        virtual ~TrajectoryUncertaintyTest() {
+            delete grid_;
+        }
+
+        virtual void SetUp() {
+        }
+
+        virtual void TearDown() { }
+
+        Grid *grid_;
+        std::string file_path_ = "../examples/ADGPRS/5spot/ECL_5SPOT.EGRID";
+        WellIndexCalculator wic_;
+    };
+
+    TEST_F(TrajectoryUncertaintyTest, latin_hypercube_samples) {
+        auto heel = Eigen::Vector3d(100, 100, 1712);
+        auto toe = Eigen::Vector3d(1300, 1250, 1712);
+        auto uncertainty = TrajectoryUncertainty(Eigen::Vector3d(10, 10, 1), Eigen::Vector3d(20, 20, 2));
+        int num_samples = 100;
+        auto samples = uncertainty.Sample(heel, toe, num_samples);
+        ASSERT_EQ(num_samples, samples.size());
+
+        // Every coordinate should have exactly one sample in each of the num_samples strata
+        for (int dim = 0; dim < 3; ++dim) {
+            std::vector<int> strata(num_samples, 0);
+            for (auto &sample : samples) {
+                double z = (sample.first[dim] - heel[dim]) / uncertainty.heel_std_dev()[dim];
+                double p = 0.5 * std::erfc(-z / std::sqrt(2.0));
+                strata[(int)(p * num_samples)]++;
+            }
+            for (int count : strata) {
+                EXPECT_EQ(1, count);
+            }
+        }
+
+        // The same seed should give the same samples
+        auto repeated = uncertainty.Sample(heel, toe, num_samples);
+        EXPECT_TRUE(samples[17].second.isApprox(repeated[17].second));
+    }
+
+    TEST_F(TrajectoryUncertaintyTest, without_uncertainty_matches_nominal) {
+        auto heel = Eigen::Vector3d(100, 100, 1712);
+        auto toe = Eigen::Vector3d(1300, 1250, 1712);
+        auto nominal_blocks = wic_.ComputeWellBlocks(heel, toe, 0.190);
+
+        auto uncertainty = TrajectoryUncertainty(Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero());
+        auto uncertainty_blocks = wic_.ComputeWellBlocks(heel, toe, 0.190, uncertainty, 20, 2);
+        EXPECT_EQ(20, uncertainty_blocks.num_samples);
+        EXPECT_EQ(0, uncertainty_blocks.num_discarded_samples);
+        ASSERT_EQ(nominal_blocks.size(), uncertainty_blocks.blocks.size());
+        for (int i = 0; i < nominal_blocks.size(); ++i) {
+            auto &statistics = uncertainty_blocks.blocks[i];
+            EXPECT_EQ(nominal_blocks[i].global_index(), statistics.global_index);
+            EXPECT_DOUBLE_EQ(nominal_blocks[i].well_index(), statistics.nominal_well_index);
+            EXPECT_NEAR(nominal_blocks[i].well_index(), statistics.mean, 1e-9);
+            EXPECT_NEAR(nominal_blocks[i].well_index(), statistics.p10, 1e-9);
+            EXPECT_NEAR(nominal_blocks[i].well_index(), statistics.p90, 1e-9);
+            EXPECT_DOUBLE_EQ(1.0, statistics.probability);
+        }
+    }
+
+    TEST_F(TrajectoryUncertaintyTest, well_index_statistics) {
+        auto heel = Eigen::Vector3d(100, 100, 1712);
+        auto toe = Eigen::Vector3d(1300, 1250, 1712);
+        auto uncertainty = TrajectoryUncertainty(Eigen::Vector3d(10, 10, 1), Eigen::Vector3d(20, 20, 2));
+        auto uncertainty_blocks = wic_.ComputeWellBlocks(heel, toe, 0.190, uncertainty, 200);
+        EXPECT_EQ(200, uncertainty_blocks.num_samples + uncertainty_blocks.num_discarded_samples);
+
+        // Perturbed trajectories penetrate blocks off the nominal path, with zeros for the samples that miss them
+        auto nominal_blocks = wic_.ComputeWellBlocks(heel, toe, 0.190);
+        EXPECT_GT(uncertainty_blocks.blocks.size(), nominal_blocks.size());
+        double total_mean = 0.0;
+        double total_nominal = 0.0;
+        for (auto &statistics : uncertainty_blocks.blocks) {
+            EXPECT_LE(statistics.p10, statistics.mean);
+            EXPECT_LE(statistics.p10, statistics.p90);
+            EXPECT_GT(statistics.probability, 0.0);
+            EXPECT_LE(statistics.probability, 1.0);
+            if (statistics.probability < 0.1) {
+                EXPECT_DOUBLE_EQ(0.0, statistics.p10);
+            }
+            total_mean += statistics.mean;
+            total_nominal += statistics.nominal_well_index;
+        }
+        EXPECT_NEAR(total_nominal, total_mean, 0.1 * total_nominal);
+    }
+}
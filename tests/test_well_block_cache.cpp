@@ -0,0 +1,171 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "Reservoir/grid/grid.h"
+#include "Reservoir/grid/eclgrid.h"
+#include "FieldOpt-WellIndexCalculator/wellindexcalculator.h"
+
+using namespace Reservoir::Grid;
+using namespace Reservoir::WellIndexCalculation;
+
+namespace {
+
+    class WellBlockCacheTest : public ::testing::Test {
+    protected:
+        WellBlockCacheTest() {
+            grid_ = new ECLGrid(file_path_);
+            wic_ = WellIndexCalculator(grid_);
+        }
+
+        virtual ~WellBlockCacheTest() {
+            delete grid_;
+            std::remove(cache_path_.c_str());
+        }
+
+        virtual void SetUp() {
+        }
+
+        virtual void TearDown() { }
+
+        Grid *grid_;
+        std::string file_path_ = "../examples/ADGPRS/5spot/ECL_5SPOT.EGRID";
+        WellIndexCalculator wic_;
+        std::string cache_path_ = "test_well_block_cache.bin";
+    };
+
+    TEST_F(WellBlockCacheTest, cached_results_match_computed) {
+        WellBlockCache cache(cache_path_, 42);
+        wic_.UseResultCache(&cache);
+
+        Eigen::Vector3d heel = Eigen::Vector3d(0, 0, 1702);
+        Eigen::Vector3d toe = Eigen::Vector3d(440, 840, 1720);
+        std::vector<IntersectedCell> cached_blocks;
+        EXPECT_FALSE(cache.Lookup(heel, toe, 0.190, grid_, cached_blocks));
+
+        auto blocks = wic_.ComputeWellBlocks(heel, toe, 0.190);
+        EXPECT_TRUE(cache.Lookup(heel, toe, 0.190, grid_, cached_blocks));
+        EXPECT_FALSE(cache.Lookup(heel, toe, 0.191, grid_, cached_blocks));
+
+        // A second cache on the same file (e.g. in a later run) sees the results; other grids do not.
+        WellBlockCache reopened_cache(cache_path_, 42);
+        WellBlockCache other_grid_cache(cache_path_, 43);
+        EXPECT_FALSE(other_grid_cache.Lookup(heel, toe, 0.190, grid_, cached_blocks));
+        ASSERT_TRUE(reopened_cache.Lookup(heel, toe, 0.190, grid_, cached_blocks));
+
+        ASSERT_EQ(blocks.size(), cached_blocks.size());
+        for (int i = 0; i < blocks.size(); ++i) {
+            EXPECT_EQ(blocks[i].global_index(), cached_blocks[i].global_index());
+            EXPECT_DOUBLE_EQ(blocks[i].well_index(), cached_blocks[i].well_index());
+            EXPECT_LT((blocks[i].entry_point() - cached_blocks[i].entry_point()).norm(), 10e-10);
+            EXPECT_LT((blocks[i].exit_point() - cached_blocks[i].exit_point()).norm(), 10e-10);
+        }
+    }
+
+    TEST_F(WellBlockCacheTest, least_recently_used_is_evicted) {
+        // Room for two entries
+        WellBlockCache cache(cache_path_, 42, 3 * 8192);
+        EXPECT_EQ(2, cache.num_slots());
+        wic_.UseResultCache(&cache);
+
+        Eigen::Vector3d heel = Eigen::Vector3d(12, 12, 1712);
+        std::vector<Eigen::Vector3d> toes = {Eigen::Vector3d(100, 12, 1712),
+                                             Eigen::Vector3d(12, 100, 1712),
+                                             Eigen::Vector3d(100, 100, 1712)};
+        std::vector<IntersectedCell> cached_blocks;
+        wic_.ComputeWellBlocks(heel, toes[0], 0.190);
+        wic_.ComputeWellBlocks(heel, toes[1], 0.190);
+        EXPECT_TRUE(cache.Lookup(heel, toes[0], 0.190, grid_, cached_blocks)); // toes[1] is now least recently used
+        wic_.ComputeWellBlocks(heel, toes[2], 0.190);
+
+        EXPECT_TRUE(cache.Lookup(heel, toes[0], 0.190, grid_, cached_blocks));
+        EXPECT_FALSE(cache.Lookup(heel, toes[1], 0.190, grid_, cached_blocks));
+        EXPECT_TRUE(cache.Lookup(heel, toes[2], 0.190, grid_, cached_blocks));
+    }
+
+    TEST_F(WellBlockCacheTest, long_wells_span_several_slots) {
+        WellBlockCache cache(cache_path_, 42, 64 * 8192);
+        EXPECT_EQ(63, cache.num_slots());
+        EXPECT_GT(cache.max_cells_per_entry(), 1000);
+
+        // More blocks than fit in a slot
+        Eigen::Vector3d heel = Eigen::Vector3d(0, 0, 1700);
+        Eigen::Vector3d toe = Eigen::Vector3d(1000, 0, 1700);
+        std::vector<IntersectedCell> blocks;
+        for (int i = 0; i < 1000; ++i) {
+            blocks.push_back(IntersectedCell(grid_->GetCell(i % 60)));
+            blocks.back().set_entry_point(Eigen::Vector3d(i, 0, 1700));
+            blocks.back().set_exit_point(Eigen::Vector3d(i + 1, 0, 1700));
+            blocks.back().set_well_index(0.001 * i);
+        }
+        EXPECT_TRUE(cache.Insert(heel, toe, 0.190, blocks));
+
+        std::vector<IntersectedCell> cached_blocks;
+        ASSERT_TRUE(cache.Lookup(heel, toe, 0.190, grid_, cached_blocks));
+        ASSERT_EQ(blocks.size(), cached_blocks.size());
+        for (int i = 0; i < blocks.size(); ++i) {
+            EXPECT_EQ(blocks[i].global_index(), cached_blocks[i].global_index());
+            EXPECT_DOUBLE_EQ(blocks[i].well_index(), cached_blocks[i].well_index());
+            EXPECT_LT((blocks[i].entry_point() - cached_blocks[i].entry_point()).norm(), 10e-10);
+        }
+
+        // Entries taking up more than a quarter of the slots are not stored
+        WellBlockCache small_cache(cache_path_ + ".small", 42, 3 * 8192);
+        EXPECT_LT(small_cache.max_cells_per_entry(), blocks.size());
+        EXPECT_FALSE(small_cache.Insert(heel, toe, 0.190, blocks));
+        EXPECT_FALSE(small_cache.Lookup(heel, toe, 0.190, grid_, cached_blocks));
+        std::remove((cache_path_ + ".small").c_str());
+    }
+
+    TEST_F(WellBlockCacheTest, grid_hash_covers_permeabilities) {
+        std::string egrid_path = "test_grid_hash.EGRID";
+        std::string init_path = WellBlockCache::InitFilePath(egrid_path);
+        std::string store_path = cache_path_ + ".gridhash";
+        EXPECT_EQ("test_grid_hash.INIT", init_path);
+        std::remove(store_path.c_str());
+        std::ofstream(egrid_path) << "geometry";
+        std::ofstream(init_path) << "permeabilities";
+        uint64_t grid_hash = WellBlockCache::HashGrid(egrid_path, store_path);
+
+        // Changing the permeabilities changes the hash
+        std::ofstream(init_path) << "other permeabilities";
+        uint64_t other_grid_hash = WellBlockCache::HashGrid(egrid_path, store_path);
+        EXPECT_NE(grid_hash, other_grid_hash);
+
+        // The stored hash is reused as long as the size and modification time of the file are unchanged
+        struct stat st;
+        stat(init_path.c_str(), &st);
+        std::ofstream(init_path) << "OTHER PERMEABILITIES";
+        struct timespec times[2] = {st.st_atim, st.st_mtim};
+        utimensat(AT_FDCWD, init_path.c_str(), times, 0);
+        EXPECT_EQ(other_grid_hash, WellBlockCache::HashGrid(egrid_path, store_path));
+
+        std::remove(egrid_path.c_str());
+        std::remove(init_path.c_str());
+        std::remove(store_path.c_str());
+    }
+}
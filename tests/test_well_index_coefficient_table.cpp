@@ -0,0 +1,94 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include "Reservoir/grid/grid.h"
+#include "Reservoir/grid/eclgrid.h"
+#include "FieldOpt-WellIndexCalculator/wellindexcalculator.h"
+#include "FieldOpt-WellIndexCalculator/compact_grid.h"
+
+using namespace Reservoir::Grid;
+using namespace Reservoir::WellIndexCalculation;
+
+namespace {
+
+    class WellIndexCoefficientTableTest : public ::testing::Test {
+    protected:
+        WellIndexCoefficientTableTest() {
+            grid_ = new ECLGrid(file_path_);
+            wic_ = WellIndexCalculator(grid_);
+        }
+
+        virtual ~WellIndexCoefficientTableTest() {
+            delete grid_;
+        }
+
+        virtual void SetUp() {
+        }
+
+        virtual void TearDown() { }
+
+        Grid *grid_;
+        std::string file_path_ = "../examples/ADGPRS/5spot/ECL_5SPOT.EGRID";
+        WellIndexCalculator wic_;
+    };
+
+    TEST_F(WellIndexCoefficientTableTest, table_matches_cell_computation) {
+        auto table = WellIndexCoefficientTable(grid_, 4);
+        auto dims = grid_->Dimensions();
+        EXPECT_EQ(dims.nx * dims.ny * dims.nz, table.num_cells());
+        EXPECT_TRUE(table.contains(0));
+        EXPECT_FALSE(table.contains(-1));
+        EXPECT_FALSE(table.contains(table.num_cells()));
+        EXPECT_EQ(60, sizeof(WellIndexCoefficientTable::Coefficients));
+
+        Eigen::Vector3d heel = Eigen::Vector3d(0, 0, 1702);
+        Eigen::Vector3d toe = Eigen::Vector3d(440, 840, 1720);
+        auto blocks = wic_.ComputeWellBlocks(heel, toe, 0.190);
+
+        auto table_wic = WellIndexCalculator(grid_);
+        table_wic.UseCoefficientTable(&table);
+        auto table_blocks = table_wic.ComputeWellBlocks(heel, toe, 0.190);
+
+        ASSERT_EQ(blocks.size(), table_blocks.size());
+        for (int i = 0; i < blocks.size(); ++i) {
+            EXPECT_EQ(blocks[i].global_index(), table_blocks[i].global_index());
+            EXPECT_NEAR(blocks[i].well_index(), table_blocks[i].well_index(), 1e-6 * blocks[i].well_index());
+        }
+    }
+
+    TEST_F(WellIndexCoefficientTableTest, compact_grid_table_matches_grid_table) {
+        auto compact_grid = CompactGrid(grid_);
+        auto table = WellIndexCoefficientTable(grid_, 4);
+        auto compact_table = WellIndexCoefficientTable(&compact_grid, 4);
+        ASSERT_EQ(table.num_cells(), compact_table.num_cells());
+        for (int i = 0; i < table.num_cells(); ++i) {
+            ASSERT_EQ(table.contains(i), compact_table.contains(i));
+            if (!table.contains(i))
+                continue;
+            EXPECT_TRUE(table.coefficients(i).directional_factors.isApprox(compact_table.coefficients(i).directional_factors, 1e-4));
+            EXPECT_TRUE(table.coefficients(i).log_wellblock_radii.isApprox(compact_table.coefficients(i).log_wellblock_radii, 1e-4));
+        }
+    }
+
+}
@@ -0,0 +1,104 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <set>
+#include "Reservoir/grid/grid.h"
+#include "Reservoir/grid/eclgrid.h"
+#include "FieldOpt-WellIndexCalculator/wellindexcalculator.h"
+
+using namespace Reservoir::Grid;
+using namespace Reservoir::WellIndexCalculation;
+
+namespace {
+
+    class WellTreeTest : public ::testing::Test {
+    protected:
+        WellTreeTest() {
+            grid_ = new ECLGrid(file_path_);
+            wic_ = WellIndexCalculator(grid_);
+        }
+
+        virtual ~WellTreeTest() {
+            delete grid_;
+        }
+
+        virtual void SetUp() {
+        }
+
+        virtual void TearDown() { }
+
+        Grid *grid_;
+        std::string file_path_ = "../examples/ADGPRS/5spot/ECL_5SPOT.EGRID";
+        WellIndexCalculator wic_;
+    };
+
+    TEST_F(WellTreeTest, junction_is_snapped_to_parent) {
+        auto tree = WellTree(Eigen::Vector3d(12, 12, 1712), Eigen::Vector3d(300, 12, 1712));
+        int lateral = tree.AddLateral(Eigen::Vector3d(100, 20, 1712), Eigen::Vector3d(100, 200, 1712));
+
+        EXPECT_EQ(1, lateral);
+        EXPECT_EQ(2, tree.branches().size());
+        EXPECT_EQ(0, tree.branches()[lateral].parent);
+        EXPECT_LT((tree.branches()[lateral].heel - Eigen::Vector3d(100, 12, 1712)).norm(), 10e-10);
+    }
+
+    TEST_F(WellTreeTest, single_branch_matches_heel_toe) {
+        Eigen::Vector3d heel = Eigen::Vector3d(12, 12, 1712);
+        Eigen::Vector3d toe = Eigen::Vector3d(300, 100, 1712);
+
+        auto blocks = wic_.ComputeWellBlocks(heel, toe, 0.190);
+        auto tree_blocks = wic_.ComputeWellBlocks(WellTree(heel, toe), 0.190);
+
+        ASSERT_EQ(blocks.size(), tree_blocks.size());
+        for (int i = 0; i < blocks.size(); ++i) {
+            EXPECT_EQ(blocks[i].global_index(), tree_blocks[i].global_index());
+            EXPECT_NEAR(blocks[i].well_index(), tree_blocks[i].well_index(), 10e-10);
+        }
+    }
+
+    TEST_F(WellTreeTest, fishbone_cells_are_merged) {
+        Eigen::Vector3d heel = Eigen::Vector3d(12, 12, 1712);
+        Eigen::Vector3d toe = Eigen::Vector3d(300, 12, 1712);
+        auto tree = WellTree(heel, toe);
+        tree.AddLateral(Eigen::Vector3d(100, 12, 1712), Eigen::Vector3d(100, 200, 1712));
+        tree.AddLateral(Eigen::Vector3d(200, 12, 1712), Eigen::Vector3d(200, 200, 1712));
+
+        auto mainbore_blocks = wic_.ComputeWellBlocks(heel, toe, 0.190);
+        auto blocks = wic_.ComputeWellBlocks(tree, 0.190);
+
+        // Every cell should only appear once
+        std::set<int> indices;
+        for (auto block : blocks) {
+            EXPECT_TRUE(indices.insert(block.global_index()).second);
+        }
+
+        // The junction cells get contributions from both the mainbore and the lateral
+        for (int i = 0; i < mainbore_blocks.size(); ++i) {
+            EXPECT_EQ(mainbore_blocks[i].global_index(), blocks[i].global_index());
+            EXPECT_GE(blocks[i].well_index(), mainbore_blocks[i].well_index() - 10e-10);
+        }
+        EXPECT_GT(blocks.size(), mainbore_blocks.size());
+    }
+
+}
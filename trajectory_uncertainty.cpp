@@ -0,0 +1,87 @@
+#include <cmath>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include "trajectory_uncertainty.h"
+
+namespace Reservoir {
+    namespace WellIndexCalculation {
+
+        namespace {
+            /*!
+             * \brief Inverse of the standard normal cumulative distribution function, using the rational
+             * approximation by P. J. Acklam (relative error below 1.2e-9).
+             */
+            double inverse_normal_cdf(double p) {
+                static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                           1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+                static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                           6.680131188771972e+01, -1.328068155288572e+01};
+                static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                           -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+                static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                           3.754408661907416e+00};
+                const double p_low = 0.02425;
+
+                if (p < p_low) {
+                    double q = sqrt(-2 * log(p));
+                    return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                           ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+                }
+                if (p > 1 - p_low) {
+                    double q = sqrt(-2 * log(1 - p));
+                    return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                           ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+                }
+                double q = p - 0.5;
+                double r = q * q;
+                return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+                       (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+            }
+        }
+
+        TrajectoryUncertainty::TrajectoryUncertainty(Vector3d heel_std_dev, Vector3d toe_std_dev, unsigned int seed) {
+            if ((heel_std_dev.array() < 0).any() || (toe_std_dev.array() < 0).any())
+                throw std::runtime_error("TrajectoryUncertainty: Standard deviations can not be negative.");
+            heel_std_dev_ = heel_std_dev;
+            toe_std_dev_ = toe_std_dev;
+            seed_ = seed;
+        }
+
+        std::vector<std::pair<Vector3d, Vector3d>> TrajectoryUncertainty::Sample(Vector3d heel, Vector3d toe,
+                                                                                  int num_samples) const {
+            std::mt19937 generator(seed_);
+            std::uniform_real_distribution<double> uniform(0.0, 1.0);
+            std::vector<std::pair<Vector3d, Vector3d>> samples(num_samples, std::make_pair(heel, toe));
+
+            // Latin hypercube: a random permutation of the strata for each coordinate, with a random
+            // position inside each stratum
+            std::vector<int> strata(num_samples);
+            for (int dim = 0; dim < 6; ++dim) {
+                std::iota(strata.begin(), strata.end(), 0);
+                std::shuffle(strata.begin(), strata.end(), generator);
+                double std_dev = dim < 3 ? heel_std_dev_[dim] : toe_std_dev_[dim - 3];
+
+                for (int i = 0; i < num_samples; ++i) {
+                    double p = (strata[i] + uniform(generator)) / num_samples;
+                    p = std::min(std::max(p, 1e-12), 1.0 - 1e-12);
+                    double deviation = std_dev * inverse_normal_cdf(p);
+                    if (dim < 3)
+                        samples[i].first[dim] += deviation;
+                    else
+                        samples[i].second[dim - 3] += deviation;
+                }
+            }
+            return samples;
+        }
+
+        const Vector3d &TrajectoryUncertainty::heel_std_dev() const {
+            return heel_std_dev_;
+        }
+
+        const Vector3d &TrajectoryUncertainty::toe_std_dev() const {
+            return toe_std_dev_;
+        }
+    }
+}
@@ -0,0 +1,96 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef FIELDOPT_TRAJECTORYUNCERTAINTY_H
+#define FIELDOPT_TRAJECTORYUNCERTAINTY_H
+
+#include <vector>
+#include <utility>
+#include <Eigen/Core>
+
+namespace Reservoir {
+namespace WellIndexCalculation {
+    using namespace Eigen;
+
+    /*!
+     * \brief The TrajectoryUncertainty class describes the uncertainty in the drilled position of a
+     * well's heel and toe, and draws perturbed trajectories from it.
+     *
+     * The deviation of each coordinate of the heel and toe is normally distributed with zero mean and
+     * independent of the others. Samples are drawn by Latin hypercube sampling: each of the six
+     * coordinates is split into num_samples strata of equal probability, and every stratum is sampled
+     * exactly once.
+     */
+    class TrajectoryUncertainty {
+    public:
+        /*!
+         * \param heel_std_dev Standard deviation of the x, y and z coordinates of the heel.
+         * \param toe_std_dev Standard deviation of the x, y and z coordinates of the toe.
+         * \param seed Seed for the random number generator; the same seed gives the same samples.
+         */
+        TrajectoryUncertainty(Vector3d heel_std_dev, Vector3d toe_std_dev, unsigned int seed = 0);
+
+        /*!
+         * \brief Draw perturbed trajectories around a nominal trajectory.
+         * \param heel The nominal heel.
+         * \param toe The nominal toe.
+         * \param num_samples The number of trajectories to draw.
+         * \return The (heel, toe) pairs of the perturbed trajectories.
+         */
+        std::vector<std::pair<Vector3d, Vector3d>> Sample(Vector3d heel, Vector3d toe, int num_samples) const;
+
+        const Vector3d &heel_std_dev() const;
+        const Vector3d &toe_std_dev() const;
+
+    private:
+        Vector3d heel_std_dev_;
+        Vector3d toe_std_dev_;
+        unsigned int seed_;
+    };
+
+    /*!
+     * \brief The WellBlockStatistics struct holds the distribution of the well index of a single block
+     * over the perturbed trajectories. Samples that do not penetrate the block count as zero.
+     */
+    struct WellBlockStatistics {
+        int global_index; //!< Global index of the block.
+        double nominal_well_index; //!< Well index along the nominal trajectory; zero if not penetrated by it.
+        double mean; //!< Mean well index.
+        double p10; //!< 10th percentile of the well index.
+        double p90; //!< 90th percentile of the well index.
+        double probability; //!< Fraction of the samples penetrating the block.
+    };
+
+    /*!
+     * \brief The TrajectoryUncertaintyWellBlocks struct holds the well index statistics of every block
+     * penetrated by the nominal trajectory or at least one of the samples.
+     */
+    struct TrajectoryUncertaintyWellBlocks {
+        std::vector<WellBlockStatistics> blocks; //!< The blocks along the nominal trajectory first, then the rest in the order they were found.
+        int num_samples; //!< Number of samples the statistics are computed from.
+        int num_discarded_samples; //!< Number of samples discarded because they left the grid or hit an inactive cell.
+    };
+}
+}
+
+#endif //FIELDOPT_TRAJECTORYUNCERTAINTY_H
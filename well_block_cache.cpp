@@ -0,0 +1,361 @@
+#include <stdexcept>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <climits>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "well_block_cache.h"
+#include "grid_access.h"
+
+namespace Reservoir {
+    namespace WellIndexCalculation {
+
+        namespace {
+            const uint64_t cache_magic = 0x5749434341434845; // "WICCACHE"
+            const uint32_t cache_version = 2;
+            const size_t slot_size = 8192; //!< Size of the header and of every slot in the file.
+            const int probe_length = 8; //!< Number of consecutive slots a key may be stored in.
+            const int max_parts_fraction = 4; //!< An entry may take up at most this fraction of the slots.
+            const double point_quantum = 1e-3;
+            const double radius_quantum = 1e-6;
+
+            struct CacheHeader {
+                uint64_t magic;
+                uint32_t version;
+                uint32_t slot_size;
+                uint64_t num_slots;
+                uint64_t clock; //!< Incremented on every access; used to find the least recently used slot.
+            };
+
+            struct CacheKey {
+                uint64_t grid_hash;
+                int64_t values[7]; //!< Quantized heel, toe and wellbore radius.
+                int64_t part; //!< The part of the entry stored in the slot, for entries spanning several slots.
+
+                bool operator==(const CacheKey &other) const {
+                    return grid_hash == other.grid_hash && std::equal(values, values + 7, other.values)
+                           && part == other.part;
+                }
+
+                uint64_t hash() const { // FNV-1a
+                    uint64_t h = 14695981039346656037ULL;
+                    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(this);
+                    for (size_t i = 0; i < sizeof(CacheKey); ++i) {
+                        h = (h ^ bytes[i]) * 1099511628211ULL;
+                    }
+                    return h;
+                }
+            };
+
+            struct SlotHeader {
+                uint64_t occupied; //!< Set last when writing a slot, and cleared first when overwriting it.
+                CacheKey key;
+                uint64_t last_used;
+                uint32_t num_cells; //!< Number of cells in this part of the entry.
+                uint32_t num_parts; //!< Number of parts (slots) in the entry.
+            };
+
+            struct CachedBlock {
+                int32_t global_index;
+                int32_t padding;
+                double exit_point[3]; //!< The entry point is the exit point of the previous block (or the heel).
+                double well_index;
+            };
+
+            /*!
+             * \brief Holds a flock on a file for as long as it is in scope.
+             */
+            class FileLock {
+            public:
+                FileLock(int fd, int operation) : fd_(fd) {
+                    while (flock(fd_, operation) != 0) {
+                        if (errno != EINTR)
+                            throw std::runtime_error("WellBlockCache: Unable to lock cache file.");
+                    }
+                }
+                ~FileLock() { flock(fd_, LOCK_UN); }
+            private:
+                int fd_;
+            };
+
+            CacheKey make_key(uint64_t grid_hash, Vector3d heel, Vector3d toe, double wellbore_radius) {
+                CacheKey key;
+                key.grid_hash = grid_hash;
+                for (int i = 0; i < 3; ++i) {
+                    key.values[i] = std::llround(heel[i] / point_quantum);
+                    key.values[3 + i] = std::llround(toe[i] / point_quantum);
+                }
+                key.values[6] = std::llround(wellbore_radius / radius_quantum);
+                key.part = 0;
+                return key;
+            }
+
+            CacheHeader *header(char *data) {
+                return reinterpret_cast<CacheHeader *>(data);
+            }
+
+            SlotHeader *slot(char *data, uint64_t index) {
+                return reinterpret_cast<SlotHeader *>(data + (index + 1) * slot_size);
+            }
+
+            CachedBlock *blocks(SlotHeader *slot) {
+                return reinterpret_cast<CachedBlock *>(slot + 1);
+            }
+
+            /*!
+             * \brief Find the slot holding a key, or nullptr if it is not in the cache.
+             */
+            SlotHeader *find_slot(char *data, const CacheKey &key) {
+                uint64_t num_slots = header(data)->num_slots;
+                uint64_t first = key.hash() % num_slots;
+                for (int i = 0; i < std::min<uint64_t>(probe_length, num_slots); ++i) {
+                    SlotHeader *s = slot(data, (first + i) % num_slots);
+                    if (s->occupied && s->key == key)
+                        return s;
+                }
+                return nullptr;
+            }
+
+            uint64_t tick(char *data) {
+                return __atomic_add_fetch(&header(data)->clock, 1, __ATOMIC_RELAXED);
+            }
+
+            int cells_per_slot() {
+                return (slot_size - sizeof(SlotHeader)) / sizeof(CachedBlock);
+            }
+        }
+
+        WellBlockCache::WellBlockCache(std::string path, uint64_t grid_hash, size_t max_size) {
+            grid_hash_ = grid_hash;
+            fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+            if (fd_ < 0)
+                throw std::runtime_error("WellBlockCache: Unable to open cache file " + path);
+
+            {
+                FileLock lock(fd_, LOCK_EX);
+
+                // Use the existing file if it is a valid cache; otherwise (re)initialize it
+                struct stat file_stat;
+                CacheHeader file_header;
+                bool valid = fstat(fd_, &file_stat) == 0
+                             && pread(fd_, &file_header, sizeof(CacheHeader), 0) == sizeof(CacheHeader)
+                             && file_header.magic == cache_magic
+                             && file_header.version == cache_version
+                             && file_header.slot_size == slot_size
+                             && file_header.num_slots > 0
+                             && file_stat.st_size == (file_header.num_slots + 1) * slot_size;
+                if (!valid) {
+                    file_header = CacheHeader{cache_magic, cache_version, slot_size,
+                                              std::max<uint64_t>(1, max_size / slot_size - 1), 0};
+                    if (ftruncate(fd_, 0) != 0
+                        || ftruncate(fd_, (file_header.num_slots + 1) * slot_size) != 0
+                        || pwrite(fd_, &file_header, sizeof(CacheHeader), 0) != sizeof(CacheHeader)) {
+                        close(fd_);
+                        throw std::runtime_error("WellBlockCache: Unable to initialize cache file " + path);
+                    }
+                }
+                size_ = (file_header.num_slots + 1) * slot_size;
+            }
+
+            void *data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+            if (data == MAP_FAILED) {
+                close(fd_);
+                throw std::runtime_error("WellBlockCache: Unable to map cache file " + path);
+            }
+            data_ = static_cast<char *>(data);
+        }
+
+        WellBlockCache::~WellBlockCache() {
+            munmap(data_, size_);
+            close(fd_);
+        }
+
+        bool WellBlockCache::Lookup(Vector3d heel, Vector3d toe, double wellbore_radius, Grid::Grid *grid,
+                                    std::vector<IntersectedCell> &well_blocks) {
+            std::lock_guard<std::mutex> guard(mutex_);
+            FileLock lock(fd_, LOCK_SH);
+
+            // The entry is only found if all of its parts are
+            CacheKey key = make_key(grid_hash_, heel, toe, wellbore_radius);
+            SlotHeader *first = find_slot(data_, key);
+            if (first == nullptr)
+                return false;
+            std::vector<SlotHeader *> parts = {first};
+            for (key.part = 1; key.part < first->num_parts; ++key.part) {
+                parts.push_back(find_slot(data_, key));
+                if (parts.back() == nullptr)
+                    return false;
+            }
+
+            well_blocks.clear();
+            Vector3d entry_point = heel;
+            uint64_t now = tick(data_);
+            for (SlotHeader *s : parts) {
+                __atomic_store_n(&s->last_used, now, __ATOMIC_RELAXED);
+                for (int i = 0; i < s->num_cells; ++i) {
+                    const CachedBlock &block = blocks(s)[i];
+                    Vector3d exit_point = Vector3d(block.exit_point[0], block.exit_point[1], block.exit_point[2]);
+                    well_blocks.push_back(IntersectedCell(GridAccess<Grid::Grid>::Cell(grid, block.global_index)));
+                    well_blocks.back().set_entry_point(entry_point);
+                    well_blocks.back().set_exit_point(exit_point);
+                    well_blocks.back().set_well_index(block.well_index);
+                    entry_point = exit_point;
+                }
+            }
+            return true;
+        }
+
+        bool WellBlockCache::Insert(Vector3d heel, Vector3d toe, double wellbore_radius,
+                                    const std::vector<IntersectedCell> &well_blocks) {
+            if (well_blocks.size() > max_cells_per_entry())
+                return false;
+            int num_parts = std::max<int>(1, (well_blocks.size() + cells_per_slot() - 1) / cells_per_slot());
+
+            std::lock_guard<std::mutex> guard(mutex_);
+            FileLock lock(fd_, LOCK_EX);
+
+            CacheKey key = make_key(grid_hash_, heel, toe, wellbore_radius);
+            std::vector<SlotHeader *> written;
+            for (key.part = 0; key.part < num_parts; ++key.part) {
+                SlotHeader *s = find_slot(data_, key);
+                if (s == nullptr) { // Use an empty slot, or evict the least recently used one
+                    uint64_t num_slots = header(data_)->num_slots;
+                    uint64_t first = key.hash() % num_slots;
+                    for (int i = 0; i < std::min<uint64_t>(probe_length, num_slots); ++i) {
+                        SlotHeader *candidate = slot(data_, (first + i) % num_slots);
+                        if (std::find(written.begin(), written.end(), candidate) != written.end())
+                            continue; // Never evict the parts of the entry being written
+                        if (!candidate->occupied) {
+                            s = candidate;
+                            break;
+                        }
+                        if (s == nullptr || candidate->last_used < s->last_used)
+                            s = candidate;
+                    }
+                    if (s == nullptr) { // All the candidate slots hold earlier parts of this entry
+                        for (SlotHeader *part : written) {
+                            part->occupied = 0;
+                        }
+                        return false;
+                    }
+                }
+
+                int first_cell = key.part * cells_per_slot();
+                int last_cell = std::min<int>(well_blocks.size(), first_cell + cells_per_slot());
+                s->occupied = 0;
+                s->key = key;
+                s->num_cells = last_cell - first_cell;
+                s->num_parts = num_parts;
+                for (int i = first_cell; i < last_cell; ++i) {
+                    CachedBlock &block = blocks(s)[i - first_cell];
+                    block.global_index = well_blocks[i].global_index();
+                    for (int d = 0; d < 3; ++d) {
+                        block.exit_point[d] = well_blocks[i].exit_point()[d];
+                    }
+                    block.well_index = well_blocks[i].well_index();
+                }
+                s->last_used = tick(data_);
+                s->occupied = 1;
+                written.push_back(s);
+            }
+            return true;
+        }
+
+        int WellBlockCache::num_slots() const {
+            return header(data_)->num_slots;
+        }
+
+        int WellBlockCache::max_cells_per_entry() const {
+            return cells_per_slot() * std::max<int>(1, num_slots() / max_parts_fraction);
+        }
+
+        uint64_t WellBlockCache::HashFile(const std::string &path) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+                throw std::runtime_error("WellBlockCache: Unable to read file " + path);
+
+            uint64_t h = 14695981039346656037ULL; // FNV-1a
+            std::vector<char> buffer(1 << 20);
+            while (file) {
+                file.read(buffer.data(), buffer.size());
+                for (std::streamsize i = 0; i < file.gcount(); ++i) {
+                    h = (h ^ static_cast<unsigned char>(buffer[i])) * 1099511628211ULL;
+                }
+            }
+            return h;
+        }
+
+        namespace {
+            /*!
+             * \brief Hash a file, reusing the hash in the hash store if the size and modification time of the file
+             * are unchanged. New hashes are added to the store.
+             */
+            uint64_t stored_file_hash(const std::string &path, const std::string &hash_store_path) {
+                struct stat st;
+                char real_path[PATH_MAX];
+                if (stat(path.c_str(), &st) != 0 || realpath(path.c_str(), real_path) == nullptr)
+                    throw std::runtime_error("WellBlockCache: Unable to read file " + path);
+                std::ostringstream key;
+                key << st.st_size << " " << st.st_mtim.tv_sec << " " << st.st_mtim.tv_nsec << " " << real_path;
+
+                // Each line in the store is "<hash> <size> <mtime s> <mtime ns> <path>"
+                std::vector<std::string> lines;
+                std::ifstream store(hash_store_path);
+                std::string line;
+                while (std::getline(store, line)) {
+                    std::istringstream fields(line);
+                    uint64_t stored_hash;
+                    long size, mtime_sec, mtime_nsec;
+                    std::string stored_path;
+                    fields >> stored_hash >> size >> mtime_sec >> mtime_nsec;
+                    fields.ignore(1);
+                    if (!std::getline(fields, stored_path))
+                        continue;
+                    if (line.substr(line.find(' ') + 1) == key.str())
+                        return stored_hash;
+                    if (stored_path != real_path)
+                        lines.push_back(line); // Drop the hashes of older versions of the file
+                }
+
+                uint64_t hash = WellBlockCache::HashFile(path);
+                lines.push_back(std::to_string(hash) + " " + key.str());
+
+                // Replace the store atomically, so that concurrent processes never see a partial file
+                std::string temporary_path = hash_store_path + "." + std::to_string(getpid());
+                {
+                    std::ofstream temporary(temporary_path);
+                    for (auto &stored_line : lines) {
+                        temporary << stored_line << "\n";
+                    }
+                    if (!temporary)
+                        throw std::runtime_error("WellBlockCache: Unable to write hash store " + hash_store_path);
+                }
+                if (std::rename(temporary_path.c_str(), hash_store_path.c_str()) != 0)
+                    throw std::runtime_error("WellBlockCache: Unable to write hash store " + hash_store_path);
+                return hash;
+            }
+        }
+
+        uint64_t WellBlockCache::HashGrid(const std::string &egrid_path, const std::string &hash_store_path) {
+            uint64_t egrid_hash = stored_file_hash(egrid_path, hash_store_path);
+            uint64_t init_hash = stored_file_hash(InitFilePath(egrid_path), hash_store_path);
+            return egrid_hash ^ (init_hash * 1099511628211ULL + 0x9e3779b97f4a7c15ULL);
+        }
+
+        std::string WellBlockCache::InitFilePath(const std::string &egrid_path) {
+            auto extension = egrid_path.rfind('.');
+            if (extension == std::string::npos)
+                throw std::runtime_error("WellBlockCache: Grid file " + egrid_path + " has no extension.");
+            bool lower_case = egrid_path.substr(extension) == ".egrid";
+            return egrid_path.substr(0, extension) + (lower_case ? ".init" : ".INIT");
+        }
+    }
+}
@@ -0,0 +1,119 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef FIELDOPT_WELLBLOCKCACHE_H
+#define FIELDOPT_WELLBLOCKCACHE_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <Eigen/Core>
+#include "Reservoir/grid/grid.h"
+#include "intersected_cell.h"
+
+namespace Reservoir {
+namespace WellIndexCalculation {
+    using namespace Eigen;
+
+    /*!
+     * \brief The WellBlockCache class is a persistent, memory-mapped hash table holding the results of
+     * WellIndexCalculator::ComputeWellBlocks.
+     *
+     * Entries are keyed by a content hash of the grid together with the heel, toe and wellbore radius,
+     * quantized to 1e-3 and 1e-6 respectively. The file has a fixed number of fixed size slots, so it
+     * never grows beyond the size it was created with; when all the slots a key may be stored in are
+     * taken, the least recently used one is evicted. Wells penetrating more blocks than fit in a slot
+     * (about 200) are stored in several slots, up to a quarter of the slots; longer wells are not cached
+     * (see max_cells_per_entry()).
+     *
+     * The cache file may be shared by several processes: lookups take a shared lock and insertions
+     * an exclusive lock on the file. The size of an existing cache file takes precedence over the
+     * size passed to the constructor.
+     */
+    class WellBlockCache {
+    public:
+        /*!
+         * \brief Open a cache file, creating it if it does not exist.
+         * \param path Path to the cache file.
+         * \param grid_hash Content hash of the grid the cached results are computed in (see HashGrid).
+         * \param max_size The maximum size of the cache file in bytes.
+         */
+        WellBlockCache(std::string path, uint64_t grid_hash, size_t max_size = 256*1024*1024);
+        ~WellBlockCache();
+
+        WellBlockCache(const WellBlockCache &) = delete;
+        WellBlockCache &operator=(const WellBlockCache &) = delete;
+
+        /*!
+         * \brief Look up the well blocks for a well.
+         * \param grid The grid used to recreate the cells of the well blocks.
+         * \param well_blocks Set to the cached well blocks if they are found.
+         * \return True if the well was found in the cache, otherwise false.
+         */
+        bool Lookup(Vector3d heel, Vector3d toe, double wellbore_radius, Grid::Grid *grid,
+                    std::vector<IntersectedCell> &well_blocks);
+
+        /*!
+         * \brief Store the well blocks for a well, evicting old entries if necessary.
+         * \return True if the well blocks were stored, or false if the well penetrates more than
+         * max_cells_per_entry() blocks.
+         */
+        bool Insert(Vector3d heel, Vector3d toe, double wellbore_radius,
+                    const std::vector<IntersectedCell> &well_blocks);
+
+        int num_slots() const;
+        int max_cells_per_entry() const;
+
+        /*!
+         * \brief Compute a 64-bit hash of the contents of a file (e.g. a grid file).
+         */
+        static uint64_t HashFile(const std::string &path);
+
+        /*!
+         * \brief Compute a 64-bit hash of the contents of the files defining an Eclipse grid: the EGRID file
+         * with the geometry and the INIT file with the permeabilities.
+         *
+         * Hashing the files of a large model takes long, so the hash of each file is stored in hash_store_path
+         * along with its size and modification time, and is only recomputed when they change.
+         * \param egrid_path Path to the EGRID file. The INIT file is expected next to it, with the same name.
+         * \param hash_store_path Path to the file the hashes are stored in. It is created if it does not exist.
+         */
+        static uint64_t HashGrid(const std::string &egrid_path, const std::string &hash_store_path);
+
+        /*!
+         * \brief The path of the INIT file belonging to an EGRID file.
+         */
+        static std::string InitFilePath(const std::string &egrid_path);
+
+    private:
+        int fd_;
+        size_t size_;
+        char *data_; //!< The memory-mapped cache file.
+        uint64_t grid_hash_;
+        std::mutex mutex_; //!< File locks are per process, so threads are serialized with a mutex.
+    };
+}
+}
+
+#endif //FIELDOPT_WELLBLOCKCACHE_H
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <stdexcept>
+#include "well_index_coefficient_table.h"
+#include "wellindexcalculator.h"
+#include "compact_grid.h"
+#include "cartesian_grid.h"
+#include "grid_access.h"
+#include "executor.h"
+
+namespace Reservoir {
+    namespace WellIndexCalculation {
+
+        WellIndexCoefficientTable::WellIndexCoefficientTable(Grid::Grid *grid, int num_threads) {
+            compute_coefficients(grid, num_threads);
+        }
+
+        WellIndexCoefficientTable::WellIndexCoefficientTable(CompactGrid *grid, int num_threads) {
+            compute_coefficients(grid, num_threads);
+        }
+
+        WellIndexCoefficientTable::WellIndexCoefficientTable(CartesianGrid *grid, int num_threads) {
+            compute_coefficients(grid, num_threads);
+        }
+
+        template<class GridType>
+        void WellIndexCoefficientTable::compute_coefficients(GridType *grid, int num_threads) {
+            auto dims = GridAccess<GridType>::Dimensions(grid);
+            int num_cells = dims.nx * dims.ny * dims.nz;
+            Coefficients inactive;
+            inactive.directional_factors.setConstant(std::numeric_limits<float>::quiet_NaN());
+            coefficients_ = std::vector<Coefficients>(num_cells, inactive);
+
+            Executor &executor = Executor::Shared();
+            if (num_threads <= 0)
+                num_threads = executor.num_threads() + 1; // The workers and the calling thread
+            num_threads = std::max(1, std::min(num_threads, num_cells));
+
+            // Each task computes the coefficients for a contiguous range of cells
+            executor.ParallelFor(num_threads, [this, grid, dims, num_cells, num_threads](int task) {
+                WellIndexCalculatorCore<GridType> wic;
+                CellGeometry cell;
+                int first = (long)num_cells * task / num_threads;
+                int last = (long)num_cells * (task + 1) / num_threads;
+                for (int i = first; i < last; ++i) {
+                    if (!GridAccess<GridType>::CellAt(grid, i % dims.nx, (i / dims.nx) % dims.ny, i / (dims.nx * dims.ny), cell))
+                        continue; // Inactive cell
+
+                    double dx = cell.xvec().norm();
+                    double dy = cell.yvec().norm();
+                    double dz = cell.zvec().norm();
+                    const Vector3d &k = cell.permeability;
+                    Coefficients &c = coefficients_[i];
+                    c.spanning_vectors.row(0) = cell.xvec().normalized().cast<float>();
+                    c.spanning_vectors.row(1) = cell.yvec().normalized().cast<float>();
+                    c.spanning_vectors.row(2) = cell.zvec().normalized().cast<float>();
+                    c.directional_factors << wic.dir_well_index_factor(k.y(), k.z()),
+                            wic.dir_well_index_factor(k.x(), k.z()),
+                            wic.dir_well_index_factor(k.x(), k.y());
+                    c.log_wellblock_radii << log(wic.dir_wellblock_radius(dy, dz, k.y(), k.z())),
+                            log(wic.dir_wellblock_radius(dx, dz, k.x(), k.z())),
+                            log(wic.dir_wellblock_radius(dx, dy, k.x(), k.y()));
+                }
+            });
+        }
+
+        int WellIndexCoefficientTable::num_cells() const {
+            return coefficients_.size();
+        }
+
+        bool WellIndexCoefficientTable::contains(int global_index) const {
+            return global_index >= 0 && global_index < coefficients_.size()
+                   && !std::isnan(coefficients_[global_index].directional_factors[0]);
+        }
+
+        const WellIndexCoefficientTable::Coefficients &WellIndexCoefficientTable::coefficients(int global_index) const {
+            return coefficients_.at(global_index);
+        }
+    }
+}
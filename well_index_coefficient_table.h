@@ -0,0 +1,98 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef FIELDOPT_WELLINDEXCOEFFICIENTTABLE_H
+#define FIELDOPT_WELLINDEXCOEFFICIENTTABLE_H
+
+#include <vector>
+#include <Eigen/Core>
+#include "Reservoir/grid/grid.h"
+
+namespace Reservoir {
+namespace WellIndexCalculation {
+    using namespace Eigen;
+
+    class CompactGrid;
+    class CartesianGrid;
+
+    /*!
+     * \brief The WellIndexCoefficientTable class holds the per-cell constants of the Projection Well
+     * Method (Shu 2005) for every cell in a grid.
+     *
+     * The directional well index in e.g. the x-direction of a cell is
+     *
+     *     WI_x = c_x * L_x / (log(r_x) - log(r_w))
+     *
+     * where L_x = |u_x . v| is the length of the projection of the well segment v onto the unit
+     * spanning vector u_x, c_x = 0.008527 * 2 * pi * sqrt(k_y * k_z), r_x is the directional wellblock
+     * radius and r_w is the wellbore radius. Only L_x and r_w depend on the well; u_x, c_x and log(r_x)
+     * are computed once for each cell and stored here.
+     *
+     * The constants are stored in single precision, taking 60 bytes per cell (e.g. 3 GB for 50M cells),
+     * which is less than the double precision corners of a cell. This gives a relative error of about
+     * 1e-7 in the well indices. Inactive cells are marked by a NaN c_x.
+     */
+    class WellIndexCoefficientTable {
+    public:
+        /*!
+         * \brief The constants for a single cell.
+         */
+        struct Coefficients {
+            Matrix3f spanning_vectors;      //!< Unit spanning vectors of the cell (rows x, y, z).
+            Vector3f directional_factors;   //!< c_x, c_y and c_z.
+            Vector3f log_wellblock_radii;   //!< log(r_x), log(r_y) and log(r_z).
+        };
+
+        /*!
+         * \brief Compute the coefficients for every cell in the grid.
+         *
+         * The cells are read from a Grid::Grid one at a time, under its lock (see GridAccess), so reading the
+         * grid bounds the time it takes to compute the table. Compact and Cartesian grids are read from all the
+         * threads at once.
+         * \param grid The grid to compute the coefficients for.
+         * \param num_threads The maximum number of threads used to compute the table, on the shared Executor
+         * and the calling thread. Defaults to all of them.
+         */
+        WellIndexCoefficientTable(Grid::Grid *grid, int num_threads = 0);
+        WellIndexCoefficientTable(CompactGrid *grid, int num_threads = 0);
+        WellIndexCoefficientTable(CartesianGrid *grid, int num_threads = 0);
+
+        int num_cells() const;
+
+        /*!
+         * \brief Check whether the table has coefficients for a cell, i.e. whether it is in the grid and active.
+         */
+        bool contains(int global_index) const;
+
+        const Coefficients &coefficients(int global_index) const;
+
+    private:
+        std::vector<Coefficients> coefficients_;
+
+        template<class GridType>
+        void compute_coefficients(GridType *grid, int num_threads);
+    };
+}
+}
+
+#endif //FIELDOPT_WELLINDEXCOEFFICIENTTABLE_H
@@ -0,0 +1,31 @@
+#include <stdexcept>
+#include <algorithm>
+#include "well_tree.h"
+
+namespace Reservoir {
+    namespace WellIndexCalculation {
+
+        WellTree::WellTree(Vector3d heel, Vector3d toe) {
+            branches_.push_back(Branch{heel, toe, -1});
+        }
+
+        int WellTree::AddLateral(Vector3d junction, Vector3d toe, int parent) {
+            if (parent < 0 || parent >= branches_.size())
+                throw std::runtime_error("WellTree::AddLateral: Parent branch does not exist.");
+
+            // Project the junction onto the parent branch
+            Vector3d parent_line = branches_[parent].toe - branches_[parent].heel;
+            double t = 0.0;
+            if (parent_line.squaredNorm() > 0.0)
+                t = parent_line.dot(junction - branches_[parent].heel) / parent_line.squaredNorm();
+            t = std::max(0.0, std::min(1.0, t));
+
+            branches_.push_back(Branch{branches_[parent].heel + t * parent_line, toe, parent});
+            return branches_.size() - 1;
+        }
+
+        const std::vector<WellTree::Branch> &WellTree::branches() const {
+            return branches_;
+        }
+    }
+}
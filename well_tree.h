@@ -0,0 +1,73 @@
+/******************************************************************************
+   Copyright (C) 2026 agent <agent@local>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef FIELDOPT_WELLTREE_H
+#define FIELDOPT_WELLTREE_H
+
+#include <vector>
+#include <Eigen/Core>
+
+namespace Reservoir {
+namespace WellIndexCalculation {
+    using namespace Eigen;
+
+    /*!
+     * \brief The WellTree class describes a multilateral (e.g. fishbone) well as a mainbore with
+     * laterals branching off it.
+     *
+     * Branch 0 is always the mainbore, defined by a heel and a toe. Every lateral starts at a
+     * junction point on its parent branch and ends in its own toe. Junction points are snapped
+     * onto the parent branch, so that the lateral starts exactly where it leaves the parent.
+     */
+    class WellTree {
+    public:
+        /*!
+         * \brief A single straight branch of the well tree.
+         */
+        struct Branch {
+            Vector3d heel; //!< Start point of the branch. For laterals, this is the junction point.
+            Vector3d toe;  //!< End point of the branch.
+            int parent;    //!< Index of the parent branch; -1 for the mainbore.
+        };
+
+        WellTree(Vector3d heel, Vector3d toe);
+
+        /*!
+         * \brief Add a lateral branching off an existing branch.
+         * \param junction The point where the lateral leaves the parent branch. It is projected
+         * onto the parent branch.
+         * \param toe The end point of the lateral.
+         * \param parent Index of the branch the lateral leaves. Defaults to the mainbore.
+         * \return The index of the new branch.
+         */
+        int AddLateral(Vector3d junction, Vector3d toe, int parent = 0);
+
+        const std::vector<Branch> &branches() const;
+
+    private:
+        std::vector<Branch> branches_;
+    };
+}
+}
+
+#endif //FIELDOPT_WELLTREE_H
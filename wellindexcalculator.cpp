@@ -23,143 +23,426 @@
 ******************************************************************************/
 
 #include <iostream>
+#include <future>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <array>
+#include <cmath>
 #include "wellindexcalculator.h"
 
 namespace Reservoir {
     namespace WellIndexCalculation {
-        WellIndexCalculator::WellIndexCalculator(Grid::Grid *grid) {
-            grid_ = grid;
+
+        namespace {
+            /*!
+             * \brief Grid backend for the trajectory samples. Cells are read from a cache shared by all the
+             * samples, and from the grid (under its lock) if they are not in it. Points are first looked for in
+             * the last cell found and its neighbours, as the traversal moves from cell to neighbour cell.
+             */
+            class CachedGrid {
+            public:
+                /*!
+                 * \param cells Read-only cache of the cells, by global index.
+                 */
+                CachedGrid(Grid::Grid *grid, const std::unordered_map<int, CellGeometry> *cells)
+                    : grid_(grid), cells_(cells) {
+                    dims_ = GridAccess<Grid::Grid>::Dimensions(grid);
+                }
+
+                bool GetCellGeometry(int i, int j, int k, CellGeometry &cell) {
+                    const CellGeometry *cached = cached_cell(i, j, k);
+                    if (cached == nullptr)
+                        return GridAccess<Grid::Grid>::CellAt(grid_, i, j, k, cell);
+                    cell = *cached;
+                    return true;
+                }
+
+                void GetCellGeometryEnvelopingPoint(const Vector3d &xyz, CellGeometry &cell) {
+                    if (last_cell_ != nullptr) {
+                        for (auto &offset : neighbour_offsets()) {
+                            const CellGeometry *cached = cached_cell(last_cell_->i + offset[0], last_cell_->j + offset[1],
+                                                                     last_cell_->k + offset[2]);
+                            if (cached != nullptr && cached->Contains(xyz, 0.0)) {
+                                last_cell_ = cached;
+                                cell = *cached;
+                                return;
+                            }
+                        }
+                    }
+                    GridAccess<Grid::Grid>::CellEnvelopingPoint(grid_, xyz, cell);
+                    auto cached = cells_->find(cell.global_index);
+                    last_cell_ = cached == cells_->end() ? nullptr : &cached->second;
+                }
+
+            private:
+                Grid::Grid *grid_;
+                Grid::Grid::Dims dims_;
+                const std::unordered_map<int, CellGeometry> *cells_;
+                const CellGeometry *last_cell_ = nullptr; //!< The last cell found, if it is in the cache.
+
+                const CellGeometry *cached_cell(int i, int j, int k) const {
+                    if (i < 0 || j < 0 || k < 0 || i >= dims_.nx || j >= dims_.ny || k >= dims_.nz)
+                        return nullptr;
+                    auto cached = cells_->find(i + dims_.nx * (j + dims_.ny * k));
+                    return cached == cells_->end() ? nullptr : &cached->second;
+                }
+
+                /*!
+                 * \brief The offsets of a cell and its 26 neighbours, the cell itself first and the face neighbours next.
+                 */
+                static const std::vector<std::array<int, 3>> &neighbour_offsets() {
+                    static const std::vector<std::array<int, 3>> offsets = []() {
+                        std::vector<std::array<int, 3>> offsets;
+                        for (int dk = -1; dk <= 1; ++dk)
+                            for (int dj = -1; dj <= 1; ++dj)
+                                for (int di = -1; di <= 1; ++di)
+                                    offsets.push_back({di, dj, dk});
+                        std::stable_sort(offsets.begin(), offsets.end(), [](const std::array<int, 3> &a, const std::array<int, 3> &b) {
+                            return std::abs(a[0]) + std::abs(a[1]) + std::abs(a[2]) < std::abs(b[0]) + std::abs(b[1]) + std::abs(b[2]);
+                        });
+                        return offsets;
+                    }();
+                    return offsets;
+                }
+            };
+        }
+
+        WellIndexCalculator::WellIndexCalculator(Grid::Grid *grid) : WellIndexCalculatorCore(grid) {
         }
 
         std::vector<IntersectedCell> WellIndexCalculator::ComputeWellBlocks(Vector3d heel, Vector3d toe, double wellbore_radius) {
             heel_ = heel;
             toe_ = toe;
             wellbore_radius_ = wellbore_radius;
+            auto start = std::chrono::steady_clock::now();
 
-            std::vector<IntersectedCell> intersected_cells = cells_intersected();
-	    
-            for (int i = 0; i < intersected_cells.size(); ++i) {
-                intersected_cells[i].set_well_index(compute_well_index(intersected_cells[i]));
+            std::vector<IntersectedCell> intersected_cells;
+            if (compact_grid_ != nullptr) { // Single precision results are kept out of the cache
+                WellIndexCalculatorCore<CompactGrid> compact_wic(compact_grid_);
+                compact_wic.UseCoefficientTable(coefficient_table_);
+                compact_wic.UseCancellationToken(cancellation_token_, deadline_);
+                intersected_cells = compact_wic.ComputeWellBlocks(heel, toe, wellbore_radius);
+            }
+            else if (result_cache_ == nullptr || !result_cache_->Lookup(heel, toe, wellbore_radius, grid_, intersected_cells)) {
+                intersected_cells = WellIndexCalculatorCore::ComputeWellBlocks(heel, toe, wellbore_radius);
+                if (result_cache_ != nullptr) {
+                    result_cache_->Insert(heel, toe, wellbore_radius, intersected_cells);
+                }
+            }
+
+            if (request_capture_ != nullptr) {
+                auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+                request_capture_->Capture(heel, toe, wellbore_radius, duration.count(), intersected_cells);
             }
             return intersected_cells;
         }
 
-        std::vector<IntersectedCell> WellIndexCalculator::cells_intersected() {
-            
-	    std::vector<IntersectedCell> intersected_cells;
-	    
-	    // Find the heel cell and add it to the list
-            intersected_cells.push_back(IntersectedCell(grid_->GetCellEnvelopingPoint(heel_)));
-            intersected_cells[0].set_entry_point(heel_);
-	    
-	    // Find the toe cell
-            Grid::Cell last_cell = grid_->GetCellEnvelopingPoint(toe_);
-
-            // If the first and last blocks are the same, return the block and start+end points
-            if (last_cell.global_index() == intersected_cells[0].global_index()) {
-                intersected_cells[0].set_exit_point(toe_);
-                return intersected_cells;
+        std::vector<IntersectedCell> WellIndexCalculator::ComputeWellBlocks(const WellTree &well_tree, double wellbore_radius) {
+            return WellIndexCalculatorCore::ComputeWellBlocks(well_tree, wellbore_radius);
+        }
+
+        EnsembleWellBlocks WellIndexCalculator::ComputeWellBlocks(Vector3d heel, Vector3d toe, double wellbore_radius,
+                                                                  const PermeabilityEnsemble &ensemble) {
+            EnsembleWellBlocks ensemble_blocks;
+            ensemble_blocks.well_blocks = ComputeWellBlocks(heel, toe, wellbore_radius);
+            ensemble_blocks.well_indices = MatrixXd(ensemble_blocks.well_blocks.size(), ensemble.num_realizations());
+
+            for (int i = 0; i < ensemble_blocks.well_blocks.size(); ++i) {
+                IntersectedCell &icell = ensemble_blocks.well_blocks[i];
+                if (icell.global_index() >= ensemble.num_cells())
+                    throw std::runtime_error("WellIndexCalculator: Well block is outside the permeability ensemble.");
+
+                // The permeabilities of this cell in all realizations
+                ArrayXd kx = ensemble.permx().row(icell.global_index());
+                ArrayXd ky = ensemble.permy().row(icell.global_index());
+                ArrayXd kz = ensemble.permz().row(icell.global_index());
+
+                Vector3d L = projected_lengths(icell);
+                ArrayXd well_index_x = dir_well_index(L.x(), icell.dy(), icell.dz(), ky, kz);
+                ArrayXd well_index_y = dir_well_index(L.y(), icell.dx(), icell.dz(), kx, kz);
+                ArrayXd well_index_z = dir_well_index(L.z(), icell.dx(), icell.dy(), kx, ky);
+                ensemble_blocks.well_indices.row(i) = (well_index_x.square() + well_index_y.square() + well_index_z.square()).sqrt();
             }
+            return ensemble_blocks;
+        }
+
+        TrajectoryUncertaintyWellBlocks WellIndexCalculator::ComputeWellBlocks(Vector3d heel, Vector3d toe,
+                                                                               double wellbore_radius,
+                                                                               const TrajectoryUncertainty &uncertainty,
+                                                                               int num_samples, int num_threads) {
+            if (num_samples <= 0)
+                throw std::runtime_error("WellIndexCalculator: The number of trajectory samples must be positive.");
+            Executor &executor = Executor::Shared();
+            if (num_threads <= 0)
+                num_threads = executor.num_threads() + 1; // The workers and the calling thread
+            num_threads = std::min(num_threads, num_samples);
+
+            std::vector<IntersectedCell> nominal_blocks = ComputeWellBlocks(heel, toe, wellbore_radius);
+            auto samples = uncertainty.Sample(heel, toe, num_samples);
 
-            // Make sure we follow line in the correct direction. (i.e. dot product positive)
-            Vector3d exit_point = find_exit_point(intersected_cells[0], heel_, toe_, heel_);
-            if ((toe_ - heel_).dot(exit_point - heel_) <= 0.0) {
-                exit_point = find_exit_point(intersected_cells[0], heel_, toe_, exit_point);
+            // Cache the cells along the nominal path and their neighbours, out to about three standard deviations
+            // of the end points (at most two cells), for all the samples to share. The neighbourhoods of
+            // consecutive blocks overlap, so cells already read (including inactive ones) are skipped.
+            double max_std_dev = std::max(uncertainty.heel_std_dev().maxCoeff(), uncertainty.toe_std_dev().maxCoeff());
+            auto dims = GridAccess<Grid::Grid>::Dimensions(grid_);
+            std::unordered_map<int, CellGeometry> cells;
+            std::unordered_set<int> read_cells;
+            for (auto &block : nominal_blocks) {
+                double cell_size = std::min(block.dx(), std::min(block.dy(), block.dz()));
+                int radius = cell_size > 0.0 ? (int)std::min(2.0, std::ceil(3.0 * max_std_dev / cell_size)) : 0;
+                for (int dk = -radius; dk <= radius; ++dk) {
+                    for (int dj = -radius; dj <= radius; ++dj) {
+                        for (int di = -radius; di <= radius; ++di) {
+                            int i = block.ijk_index().i() + di;
+                            int j = block.ijk_index().j() + dj;
+                            int k = block.ijk_index().k() + dk;
+                            if (i < 0 || j < 0 || k < 0 || i >= dims.nx || j >= dims.ny || k >= dims.nz
+                                || !read_cells.insert(i + dims.nx * (j + dims.ny * k)).second)
+                                continue;
+                            CellGeometry cell;
+                            if (GridAccess<Grid::Grid>::CellAt(grid_, i, j, k, cell))
+                                cells.emplace(cell.global_index, cell);
+                        }
+                    }
+                }
             }
-            intersected_cells[0].set_exit_point(exit_point);
 
-            double epsilon = 0.01 / (toe_ - exit_point).norm();
+            // Each task computes the well blocks for a contiguous range of samples, keeping only the global
+            // indices and well indices
+            std::vector<std::vector<std::pair<int, double>>> sample_blocks(num_samples);
+            std::vector<char> discarded(num_samples, 0);
+            executor.ParallelFor(num_threads, [&](int task) {
+                CachedGrid cached_grid(grid_, &cells);
+                WellIndexCalculatorCore<CachedGrid> sample_wic(&cached_grid);
+                sample_wic.UseCoefficientTable(coefficient_table_);
+                sample_wic.UseCancellationToken(cancellation_token_, deadline_);
+                int first = (long)num_samples * task / num_threads;
+                int last = (long)num_samples * (task + 1) / num_threads;
+                for (int s = first; s < last; ++s) {
+                    std::vector<IntersectedCell> blocks;
+                    try {
+                        blocks = sample_wic.ComputeWellBlocks(samples[s].first, samples[s].second, wellbore_radius);
+                    }
+                    catch (const WellIndexCalculationCancelled &) {
+                        throw;
+                    }
+                    catch (const std::runtime_error &) { // Outside the grid or inactive cell
+                        discarded[s] = 1;
+                        continue;
+                    }
+                    for (auto &block : blocks) {
+                        sample_blocks[s].push_back(std::make_pair(block.global_index(), block.well_index()));
+                    }
+                }
+            });
 
-            // Add previous exit point to list, find next exit point and all other up to the end_point    
-            while (true) {		
-                // Move into the next cell, add it to the list and set the entry point
-                Vector3d move_exit_epsilon = exit_point * (1 - epsilon) + toe_ * epsilon;
-                intersected_cells.push_back(IntersectedCell(grid_->GetCellEnvelopingPoint(move_exit_epsilon)));
-                intersected_cells.back().set_entry_point(exit_point); // The entry point of each cell is the exit point of the previous cell
+            // Collect the well indices in a (blocks x samples) matrix; samples missing a block count as zero
+            TrajectoryUncertaintyWellBlocks uncertainty_blocks;
+            uncertainty_blocks.num_discarded_samples = std::count(discarded.begin(), discarded.end(), 1);
+            uncertainty_blocks.num_samples = num_samples - uncertainty_blocks.num_discarded_samples;
+            if (uncertainty_blocks.num_samples == 0)
+                throw std::runtime_error("WellIndexCalculator: All trajectory samples left the grid.");
 
-                // Terminate if we're in the last cell
-                if (intersected_cells.back().global_index() == last_cell.global_index()) {
-                    intersected_cells.back().set_exit_point(toe_);
-                    break;
+            std::unordered_map<int, int> block_rows;
+            for (auto &block : nominal_blocks) {
+                block_rows[block.global_index()] = uncertainty_blocks.blocks.size();
+                uncertainty_blocks.blocks.push_back(WellBlockStatistics{block.global_index(), block.well_index(),
+                                                                       0.0, 0.0, 0.0, 0.0});
+            }
+            for (int s = 0; s < num_samples; ++s) {
+                for (auto &block : sample_blocks[s]) {
+                    if (block_rows.find(block.first) == block_rows.end()) {
+                        block_rows[block.first] = uncertainty_blocks.blocks.size();
+                        uncertainty_blocks.blocks.push_back(WellBlockStatistics{block.first, 0.0, 0.0, 0.0, 0.0, 0.0});
+                    }
+                }
+            }
+
+            MatrixXd well_indices = MatrixXd::Zero(uncertainty_blocks.blocks.size(), uncertainty_blocks.num_samples);
+            VectorXi hits = VectorXi::Zero(uncertainty_blocks.blocks.size());
+            for (int s = 0, column = 0; s < num_samples; ++s) {
+                if (discarded[s])
+                    continue;
+                for (auto &block : sample_blocks[s]) {
+                    int row = block_rows[block.first];
+                    well_indices(row, column) += block.second;
+                    hits[row]++;
                 }
+                column++;
+            }
 
-                // Find the exit point of the cell and set it in the list
-                exit_point = find_exit_point(intersected_cells.back(), exit_point, toe_, exit_point);
-                intersected_cells.back().set_exit_point(exit_point);
-                assert(intersected_cells.size() < 500);		
+            // Percentiles are interpolated linearly between the sorted samples
+            auto percentile = [](const ArrayXd &sorted, double q) {
+                double position = q * (sorted.size() - 1);
+                int lower = (int)std::floor(position);
+                int upper = std::min(lower + 1, (int)sorted.size() - 1);
+                return sorted[lower] + (position - lower) * (sorted[upper] - sorted[lower]);
+            };
+            for (int i = 0; i < uncertainty_blocks.blocks.size(); ++i) {
+                ArrayXd sorted = well_indices.row(i).transpose();
+                std::sort(sorted.data(), sorted.data() + sorted.size());
+                WellBlockStatistics &statistics = uncertainty_blocks.blocks[i];
+                statistics.mean = sorted.mean();
+                statistics.p10 = percentile(sorted, 0.1);
+                statistics.p90 = percentile(sorted, 0.9);
+                statistics.probability = (double)hits[i] / uncertainty_blocks.num_samples;
             }
-	    
-            assert(intersected_cells.back().global_index() == last_cell.global_index());
-            return intersected_cells;
+            return uncertainty_blocks;
         }
 
-        Vector3d WellIndexCalculator::find_exit_point(Grid::Cell &cell, Vector3d &entry_point,
-                                                      Vector3d &end_point, Vector3d &exception_point) {
-            Vector3d line = end_point - entry_point;
-
-            // Loop through the cell faces until we find one that the line intersects
-            for (Grid::Cell::Face face : cell.faces()) {
-                if (face.normal_vector.dot(line) != 0) { // Check that the line and face are not parallel.
-                    auto intersect_point = face.intersection_with_line(entry_point, end_point);
-
-                    // Check that the intersect point is on the correct side of all faces (i.e. inside the cell)
-                    bool feasible_point = true;
-                    for (auto p : cell.faces()) {
-                        if (!p.point_on_same_side(intersect_point, 10e-6)) {
-                            feasible_point = false;
-                            break;
-                        }
+        ApproximateWellBlocks WellIndexCalculator::ComputeWellBlocksApproximate(Vector3d heel, Vector3d toe,
+                                                                                double wellbore_radius, double tolerance) {
+            if (tolerance <= 0)
+                throw std::runtime_error("WellIndexCalculator: The tolerance of the approximate mode must be positive.");
+            heel_ = heel;
+            toe_ = toe;
+            wellbore_radius_ = wellbore_radius;
+            double length = (toe_ - heel_).norm();
+            Vector3d direction = length > 0.0 ? Vector3d((toe_ - heel_) / length) : Vector3d::Zero();
+            double step = 1e-6 * length; // Minimum progress along the path for each cell
+            auto dims = GridAccess<Grid::Grid>::Dimensions(grid_);
+            int max_blocks = 4 * (dims.nx + dims.ny + dims.nz); // A straight path crosses at most about nx + ny + nz cells
+
+            // The cell across a face, if the grid has one there
+            auto neighbour = [this](const CellGeometry &cell, int face, CellGeometry &next_cell) {
+                int d = face % 2 == 0 ? -1 : 1;
+                return GridAccess<Grid::Grid>::CellAt(grid_, cell.i + (face / 2 == 2 ? d : 0), cell.j + (face / 2 == 1 ? d : 0),
+                                                      cell.k + (face / 2 == 0 ? d : 0), next_cell);
+            };
+
+            // The heel and toe cells are the only ones that are always located in the grid. Every cell is held with
+            // the face planes of the grid, and with the planes computed from its corners in faces.
+            CellGeometry cell;
+            CellGeometry last_cell;
+            GridAccess<Grid::Grid>::CellEnvelopingPoint(grid_, heel_, cell);
+            GridAccess<Grid::Grid>::CellEnvelopingPoint(grid_, toe_, last_cell);
+            CellGeometry faces = cell;
+            faces.SetFacesFromCorners();
+
+            ApproximateWellBlocks approximate_blocks;
+            double total_well_index = 0.0;
+            double total_error = 0.0;
+            double entry = 0.0; // Distances along the path
+            double entry_error = 0.0;
+            double plane_entry = 0.0; // Where the path crosses the plane of the entry face computed from the corners
+            while (true) {
+                check_cancellation();
+                if (approximate_blocks.well_blocks.size() >= max_blocks)
+                    throw std::runtime_error("WellIndexCalculator: The approximate traversal did not reach the toe.");
+
+                bool last = cell.global_index == last_cell.global_index;
+                double exit = length;
+                double exit_error = 0.0;
+                CellGeometry next_cell;
+                CellGeometry next_faces;
+                if (!last) {
+                    // Leave the cell through the nearest face plane computed from the corners, into the neighbour
+                    // across it. The boundary is kept if its uncertainty is within half the tolerance of the blocks
+                    // on both sides, and the path is in the cell and the neighbour on either side of it. The lengths
+                    // of the blocks are measured between the face planes, so that whether a boundary is kept does
+                    // not depend on whether the ones before it are.
+                    int face;
+                    double plane_exit = plane_entry + std::max(faces.exit_distance(heel_ + plane_entry * direction,
+                                                                                   direction, face), step);
+                    bool approximate = face >= 0 && plane_exit < length && neighbour(cell, face, next_cell)
+                                       && next_cell.global_index != cell.global_index;
+                    if (approximate) {
+                        exit = plane_exit;
+                        exit_error = faces.crossing_uncertainty(face, heel_ + exit * direction, direction);
+                        next_faces = next_cell;
+                        next_faces.SetFacesFromCorners();
+                        int next_face;
+                        double next_length = next_cell.global_index == last_cell.global_index ? length - exit
+                                             : next_faces.exit_distance(heel_ + exit * direction, direction, next_face);
+                        approximate = exit_error <= 0.5 * tolerance * std::min(exit - plane_entry, next_length)
+                                      && cell.Contains(heel_ + (exit - exit_error - step) * direction, 0.0)
+                                      && next_cell.Contains(heel_ + (exit + exit_error + step) * direction, 0.0);
                     }
+                    int approximate_face = face;
 
-                    // Return the point if it is deemed feasible, not identical to the entry point, and going in the correct direction.
-                    if (feasible_point && (exception_point - intersect_point).norm() > 10e-10
-                        && (end_point - entry_point).dot(end_point - intersect_point) >= 0) {
-                        return intersect_point;
+                    // Otherwise leave the cell through the face planes of the grid and locate the cell past the exit
+                    // point, as in exact mode
+                    if (!approximate) {
+                        exit = entry + std::max(cell.exit_distance(heel_ + entry * direction, direction, face), step);
+                        exit_error = 0.0;
+                        last = face < 0 || exit >= length;
+                        if (last) {
+                            exit = length;
+                        }
+                        else {
+                            Vector3d next_point = heel_ + std::min(length, exit + 0.01) * direction;
+                            if (!neighbour(cell, face, next_cell) || !next_cell.Contains(next_point, 0.0))
+                                GridAccess<Grid::Grid>::CellEnvelopingPoint(grid_, next_point, next_cell);
+                            next_faces = next_cell;
+                            next_faces.SetFacesFromCorners();
+                            if (face != approximate_face) // Not the boundary found from the face planes
+                                plane_exit = exit;
+                        }
                     }
+                    plane_entry = plane_exit;
                 }
-            }
-            // If all fails, the line intersects the cell in a single point (corner or edge) -> return entry_point
-            return entry_point;
-        }
 
-        double WellIndexCalculator::compute_well_index(IntersectedCell &icell) {
-            double Lx = 0;
-            double Ly = 0;
-            double Lz = 0;
+                // Compute the well index of the block
+                TraversedCell block;
+                block.cell = cell;
+                block.entry_point = heel_ + entry * direction;
+                block.exit_point = last ? toe_ : Vector3d(heel_ + exit * direction);
+                approximate_blocks.well_blocks.push_back(intersected_cell(block));
+                IntersectedCell &icell = approximate_blocks.well_blocks.back();
+                icell.set_well_index(compute_well_index(cell, projected_lengths(cell, block.exit_point - block.entry_point)));
 
-            for (int ii = 0; ii < icell.points().size() - 1; ++ii) { // Current segment ii
-                // Compute vector from segment
-                Vector3d current_vec = icell.points().at(ii+1) - icell.points().at(ii);
+                // The well index is proportional to the length of the path in the block
+                double block_length = exit - entry;
+                double relative_error = block_length > 0.0 ? std::min(1.0, (entry_error + exit_error) / block_length) : 1.0;
+                approximate_blocks.relative_errors.push_back(relative_error);
+                total_well_index += icell.well_index();
+                total_error += relative_error * icell.well_index();
 
-                /* Projects segment vector to directional spanning vectors and determines the length.
-                 * of the projections. Note that we only only care about the length of the projection,
-                 * not the spatial position. Also adds the lengths of previous segments in case there
-                 * is more than one segment within the well.
-                 */
-                Lx = Lx + (icell.xvec() * icell.xvec().dot(current_vec) / icell.xvec().dot(icell.xvec())).norm();
-                Ly = Ly + (icell.yvec() * icell.yvec().dot(current_vec) / icell.yvec().dot(icell.yvec())).norm();
-                Lz = Lz + (icell.zvec() * icell.zvec().dot(current_vec) / icell.zvec().dot(icell.zvec())).norm();
+                if (last)
+                    break;
+                cell = next_cell;
+                faces = next_faces;
+                entry = exit;
+                entry_error = exit_error;
             }
+            approximate_blocks.relative_error = total_well_index > 0.0 ? total_error / total_well_index : 0.0;
+            return approximate_blocks;
+        }
+
+        std::future<std::vector<IntersectedCell>> WellIndexCalculator::ComputeWellBlocksAsync(
+            Vector3d heel, Vector3d toe, double wellbore_radius,
+            CancellationToken cancellation_token, std::chrono::steady_clock::time_point deadline) {
+            auto result = std::make_shared<std::promise<std::vector<IntersectedCell>>>();
+            auto future = result->get_future();
+            WellIndexCalculator wic(*this);
+            wic.UseCancellationToken(cancellation_token, deadline);
+
+            Executor::Shared().Submit([result, wic, heel, toe, wellbore_radius]() mutable {
+                try {
+                    wic.check_cancellation();
+                    result->set_value(wic.ComputeWellBlocks(heel, toe, wellbore_radius));
+                }
+                catch (...) {
+                    result->set_exception(std::current_exception());
+                }
+            });
+            return future;
+        }
 
-            // Compute Well Index from formula provided by Shu
-            double well_index_x = (dir_well_index(Lx, icell.dy(), icell.dz(), icell.permy(), icell.permz()));
-            double well_index_y = (dir_well_index(Ly, icell.dx(), icell.dz(), icell.permx(), icell.permz()));
-            double well_index_z = (dir_well_index(Lz, icell.dx(), icell.dy(), icell.permx(), icell.permy()));
-            double wi = sqrt(well_index_x * well_index_x + well_index_y * well_index_y + well_index_z * well_index_z);
-            return wi;
+        void WellIndexCalculator::UseCompactGrid(CompactGrid *compact_grid) {
+            compact_grid_ = compact_grid;
         }
 
-        double WellIndexCalculator::dir_well_index(double Lx, double dy, double dz, double ky, double kz) {
-            double silly_eclipse_factor = 0.008527;
-            double well_index_i = silly_eclipse_factor * (2 * M_PI * sqrt(ky * kz) * Lx) /
-                                  (log(dir_wellblock_radius(dy, dz, ky, kz) / wellbore_radius_));
-            return well_index_i;
+        void WellIndexCalculator::UseResultCache(WellBlockCache *result_cache) {
+            result_cache_ = result_cache;
         }
 
-        double WellIndexCalculator::dir_wellblock_radius(double dx, double dy, double kx, double ky) {
-            double r = 0.28 * sqrt((dx * dx) * sqrt(ky / kx) + (dy * dy) * sqrt(kx / ky)) /
-                       (sqrt(sqrt(kx / ky)) + sqrt(sqrt(ky / kx)));
-            return r;
+        void WellIndexCalculator::UseRequestCapture(RequestCapture *request_capture) {
+            request_capture_ = request_capture;
         }
     }
 }
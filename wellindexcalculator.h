@@ -27,14 +27,35 @@
 
 #include <Eigen/Dense>
 #include <vector>
+#include <future>
+#include <chrono>
 #include <Eigen/Core>
 #include "Reservoir/grid/grid.h"
 #include "intersected_cell.h"
+#include "well_tree.h"
+#include "permeability_ensemble.h"
+#include "trajectory_uncertainty.h"
+#include "well_index_coefficient_table.h"
+#include "well_block_cache.h"
+#include "request_capture.h"
+#include "wellindexcalculator_core.h"
+#include "compact_grid.h"
+#include "executor.h"
 
 namespace Reservoir {
     namespace WellIndexCalculation {
         using namespace Eigen;
 
+        /*!
+         * \brief The ApproximateWellBlocks struct holds the well blocks computed in approximate mode, along
+         * with estimates of their errors.
+         */
+        struct ApproximateWellBlocks {
+            std::vector<IntersectedCell> well_blocks; //!< The blocks penetrated by the well.
+            std::vector<double> relative_errors; //!< Estimated relative error of the well index of each block.
+            double relative_error; //!< Estimated relative error of the sum of the well indices.
+        };
+
         /*!
          * \brief The WellIndexCalculation class deduces the well blocks and their respecitve well indices/transmissibility
          * factors for one or more well splines defined by a heel and a toe.
@@ -43,9 +64,17 @@ namespace Reservoir {
          * because the internal methods support well splines consisting of more than one point. This is, however, not yet
          * supported by the Model library and so have been "hidden".
          *
+         * The traversal and the well index computations are implemented in WellIndexCalculatorCore; this class
+         * instantiates it for the abstract Grid::Grid and adds multilateral wells, ensembles, the approximate
+         * mode and result caching on top.
+         *
+         * Any number of calculators sharing a grid may be used from different threads at the same time, as
+         * their calls into the grid are serialized (see GridAccess<Grid::Grid>). A single calculator must only
+         * be used by one thread at a time; ComputeWellBlocksAsync runs on a copy.
+         *
          * Credit for computations in this class goes to @hilmarm.
          */
-        class WellIndexCalculator {
+        class WellIndexCalculator : public WellIndexCalculatorCore<Grid::Grid> {
         public:
             WellIndexCalculator(){}
             WellIndexCalculator(Grid::Grid *grid);
@@ -60,81 +89,128 @@ namespace Reservoir {
              */
             std::vector<IntersectedCell> ComputeWellBlocks(Vector3d heel, Vector3d toe, double wellbore_radius);
 
-        private:
             /*!
-             * \brief The Well struct holds the information needed to compute the well blocks and their
-             * respective well indices for a well spline consisting of a heel and a toe.
+             * \brief Compute the well block data for a multilateral well.
+             * \see WellIndexCalculatorCore::ComputeWellBlocks(const WellTree &, double)
              */
+            std::vector<IntersectedCell> ComputeWellBlocks(const WellTree &well_tree, double wellbore_radius);
 
-            Grid::Grid *grid_; //!< The grid used in the calculations.
-            double wellbore_radius_;
-            Vector3d heel_;
-            Vector3d toe_;
-
-        public:
             /*!
-             * \brief Given a reservoir with blocks and a line(start_point to end_point), return global index of all
-             * blocks interesected by the line, as well as the point where the line enters the block.
-             * by the line and the points of intersection
-             * \param start_point The start point of the well path.
-             * \param end_point The end point of the well path.
-             * \param grid The grid object containing blocks/cells.
-             * \return A pair containing global indeces of intersected cells and the points where it enters each cell
-             * (and thereby leaves the previous cell) of the line segment inside each cell.
+             * \brief Compute the well indices for a single well in every realization of an ensemble.
+             *
+             * The realizations share the grid geometry, so the well path is only traversed once. The well
+             * indices for all realizations are then computed together for each block.
+             * \param heel The heel end point of the spline defining the well.
+             * \param toe The toe end point of the spline defining the well.
+             * \param wellbore_radius The radius of the well.
+             * \param ensemble The permeabilities of the realizations.
+             * \return The blocks intersected by the spline and a (blocks x realizations) matrix of well indices.
+             * The well_index of the blocks themselves is computed from the permeabilities in the grid.
              */
-            std::vector<IntersectedCell> cells_intersected();
+            EnsembleWellBlocks ComputeWellBlocks(Vector3d heel, Vector3d toe, double wellbore_radius,
+                                                 const PermeabilityEnsemble &ensemble);
 
             /*!
-             * \brief Find the point where the line bethween the start_point and end_point exits a cell.
+             * \brief Compute the distribution of the well indices of a single well under trajectory uncertainty.
              *
-             * Takes as input an entry_point end_point which defines the well path. Finds the two points on the path
-             * which intersects the block faces and chooses the one that is not the entry point, i.e. the exit point.
-             *
-             * \todo Find a better name for the exception_point and describe it better.
-             *
-             * \param cell The cell to find the well paths exit point in.
-             * \param start_point The start point of the well path.
-             * \param end_point The end point of the well path.
-             * \param exception_point A specific point we don't want the function to end up in.
-             * \return The point where the well path exits the cell.
+             * The well blocks of num_samples perturbed trajectories drawn from the uncertainty model are computed
+             * in parallel on the shared Executor, and only the per-block statistics are kept. The cells along the
+             * nominal trajectory and their neighbours are read from the grid once and cached for all the samples;
+             * samples reaching further only read the cells outside the cache from the grid. The samples share
+             * the coefficient table of this calculator, if set, which should be used for large numbers of
+             * samples. They do not use the result cache or the request capture. Samples leaving the grid or
+             * hitting an inactive cell are discarded.
+             * \param heel The nominal heel end point of the spline defining the well.
+             * \param toe The nominal toe end point of the spline defining the well.
+             * \param wellbore_radius The radius of the well.
+             * \param uncertainty The uncertainty model to draw trajectories from.
+             * \param num_samples The number of trajectories to draw.
+             * \param num_threads The maximum number of threads used, on the shared Executor and the calling thread.
+             * Defaults to all of them.
+             * \return Statistics of the well index of every block penetrated by the nominal trajectory or any
+             * of the samples.
              */
-            Vector3d find_exit_point(Grid::Cell &cell, Vector3d &start_point,
-                                     Vector3d &end_point, Vector3d &exception_point);
+            TrajectoryUncertaintyWellBlocks ComputeWellBlocks(Vector3d heel, Vector3d toe, double wellbore_radius,
+                                                              const TrajectoryUncertainty &uncertainty,
+                                                              int num_samples, int num_threads = 0);
 
             /*!
-             * \brief Compute the well index (aka. transmissibility factor) for a (one) single cell/block by
-             * using the Projection Well Method (Shu 2005).
+             * \brief Compute approximate well block data for a single well.
              *
-             * Assumption: The block is fairly regular, i.e. corners are straight angles.
+             * Instead of locating every cell along the well path in the grid, the traversal steps from a cell
+             * to its (i,j,k) neighbour across the face the path leaves through, found from the face planes
+             * computed from the corners (see CellGeometry::SetFacesFromCorners). Where the faces are warped,
+             * the path may cross the face itself up to CellGeometry::crossing_uncertainty from where it crosses
+             * the plane. Such a boundary is kept if that is at most half the tolerance times the length of the
+             * path in the blocks on both sides of it; otherwise, and where the path does not continue into the
+             * neighbour (e.g. across faults), the boundary and the cell past it are found as in exact mode.
              *
-             * \note Corner points of Cell(s) are always listed in the same order and orientation. (see
-             * Grid::Cell for illustration).
+             * The well index of a block is proportional to the length of the path inside it, so the estimated
+             * relative error of a block is the uncertainty of its two boundaries relative to that length. It
+             * bounds the difference from the exact well index, and is at most about the tolerance. A smaller
+             * tolerance finds more boundaries as in exact mode; it is exact on grids with planar faces.
+             * \param heel The heel end point of the spline defining the well.
+             * \param toe The toe end point of the spline defining the well.
+             * \param wellbore_radius The radius of the well.
+             * \param tolerance The largest relative error of the well index of each block.
+             * \return The well blocks and their estimated errors.
+             */
+            ApproximateWellBlocks ComputeWellBlocksApproximate(Vector3d heel, Vector3d toe, double wellbore_radius,
+                                                               double tolerance);
+
+            /*!
+             * \brief Compute the well block data for a single well on the shared Executor.
              *
-             * \param icell Well block to compute the WI in.
-             * \return Well index for block/cell
-            */
-            double compute_well_index(IntersectedCell &icell);
+             * The computation runs on a copy of this calculator, using the same grid, coefficient table, cache
+             * and capture, so the calculator may be reused while it runs. When the token is cancelled or the
+             * deadline passes, the traversal stops at the next cell and the future holds a
+             * WellIndexCalculationCancelled exception; a computation that is cancelled while queued never starts.
+             * \param heel The heel end point of the spline defining the well.
+             * \param toe The toe end point of the spline defining the well.
+             * \param wellbore_radius The radius of the well.
+             * \param cancellation_token Token to cancel the computation with.
+             * \param deadline The time after which the computation is abandoned. Defaults to no deadline.
+             * \return A future for the result of ComputeWellBlocks(heel, toe, wellbore_radius).
+             */
+            std::future<std::vector<IntersectedCell>> ComputeWellBlocksAsync(
+                Vector3d heel, Vector3d toe, double wellbore_radius,
+                CancellationToken cancellation_token = CancellationToken(),
+                std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+
+            /*!
+             * \brief Use a persistent cache for the results of ComputeWellBlocks(heel, toe, wellbore_radius).
+             * \param result_cache The cache to use, or nullptr to stop using a cache. The cache must have been
+             * created for the grid used by this calculator; it is not owned by the calculator, and must outlive it.
+             */
+            void UseResultCache(WellBlockCache *result_cache);
 
             /*!
-             * \brief Auxilary function for compute_well_index function
-             * \param Lx lenght of projection in first direction
-             * \param dy size block second direction
-             * \param dz size block third direction
-             * \param ky permeability second direction
-             * \param kz permeability second direction
-             * \return directional well index
-            */
-            double dir_well_index(double Lx, double dy, double dz, double ky, double kz);
+             * \brief Capture every ComputeWellBlocks(heel, toe, wellbore_radius) request, along with a summary of
+             * its result, e.g. to replay them with WellIndexCalcReplay.
+             *
+             * The capture format and the replay only cover single wells in exact mode, so multilateral wells and
+             * the approximate mode are not captured. The ensemble and trajectory uncertainty computations only
+             * capture the well blocks of the nominal well, as a single well request, and ComputeWellBlocksAsync
+             * is captured as ComputeWellBlocks.
+             * \param request_capture The capture to log to, or nullptr to stop capturing. It is not owned by the
+             * calculator, and must outlive it.
+             */
+            void UseRequestCapture(RequestCapture *request_capture);
 
             /*!
-             * \brief Auxilary function(2) for compute_well_index function
-             * \param dx size block second direction
-             * \param dy size block third direction
-             * \param kx permeability second direction
-             * \param ky permeability second direction
-             * \return directional wellblock radius
+             * \brief Compute ComputeWellBlocks(heel, toe, wellbore_radius) in a compact copy of the grid instead of
+             * the Grid::Grid. See CompactGrid for the precision of the results; they are not read from or stored
+             * in the result cache, which only holds exact results.
+             * \param compact_grid A compact copy of the grid used by this calculator, or nullptr to stop using it.
+             * It is not owned by the calculator, and must outlive it.
              */
-            double dir_wellblock_radius(double dx, double dy, double kx, double ky);
+            void UseCompactGrid(CompactGrid *compact_grid);
+
+        private:
+            CompactGrid *compact_grid_ = nullptr; //!< Optional compact copy of the grid.
+            WellBlockCache *result_cache_ = nullptr; //!< Optional persistent result cache.
+            RequestCapture *request_capture_ = nullptr; //!< Optional capture of all requests.
         };
 
     }
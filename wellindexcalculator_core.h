@@ -0,0 +1,540 @@
+/******************************************************************************
+   Copyright (C) 2015-2016 Hilmar M. Magnusson <hilmarmag@gmail.com>
+   Modified by Einar J.M. Baumann (2016) <einar.baumann@gmail.com>
+
+   This file and the WellIndexCalculator as a whole is part of the
+   FieldOpt project. However, unlike the rest of FieldOpt, the
+   WellIndexCalculator is provided under the GNU Lesser General Public
+   License.
+
+   WellIndexCalculator is free software: you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation, either version 3 of
+   the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef WELLINDEXCALCULATOR_CORE_H
+#define WELLINDEXCALCULATOR_CORE_H
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <chrono>
+#include <unordered_map>
+#include <Eigen/Core>
+#include "Reservoir/grid/grid.h"
+#include "intersected_cell.h"
+#include "well_index_coefficient_table.h"
+#include "cancellation.h"
+#include "cell_geometry.h"
+#include "grid_access.h"
+#include "well_tree.h"
+#include "executor.h"
+
+namespace Reservoir {
+    namespace WellIndexCalculation {
+        using namespace Eigen;
+
+        /*!
+         * \brief The WellIndexCalculatorCore class template contains the traversal of the grid along a well path
+         * and the well index computations, for a specific type of grid.
+         *
+         * The cells are accessed through GridAccess<GridType>, and the traversal and well index computations
+         * work on CellGeometry objects, which are filled in place without allocating. When GridType is a
+         * concrete backend with non-virtual methods (e.g. CartesianGrid), the cell access and geometry are
+         * inlined into the traversal, and Grid::Cell objects are only created for the well blocks returned.
+         * WellIndexCalculator is the instantiation for the abstract Grid::Grid, extended with the remaining
+         * features.
+         *
+         * Credit for computations in this class goes to @hilmarm.
+         */
+        template<class GridType>
+        class WellIndexCalculatorCore {
+        public:
+            WellIndexCalculatorCore(){}
+            WellIndexCalculatorCore(GridType *grid) { grid_ = grid; }
+
+            /*!
+             * \brief Compute the well block data for a single well.
+             * \param heel The heel end point of the spline defining the well.
+             * \param toe The toe end point of the spline defining the well.
+             * \param wellbore_radius The radius of the well.
+             * \return A list of BlockData objects containing the (i,j,k) index and well index/transmissibility factor
+             * for every block intersected by the spline.
+             */
+            std::vector<IntersectedCell> ComputeWellBlocks(Vector3d heel, Vector3d toe, double wellbore_radius);
+
+            /*!
+             * \brief Compute the well block data for a multilateral well.
+             *
+             * Each branch in the tree is traversed once, and the branches are traversed in parallel on the shared
+             * Executor. Cells penetrated by more than one branch (e.g. at the junctions) are merged into a single
+             * well block, and its well index is computed from all the segments inside the cell.
+             *
+             * The branches only run concurrently on backends that may be read from several threads at once, such
+             * as CompactGrid and CartesianGrid. Calls into a Grid::Grid are serialized (see GridAccess), and as
+             * they dominate the traversal, the branches of a well in a Grid::Grid are in effect traversed one at
+             * a time.
+             * \param well_tree The mainbore and laterals of the well.
+             * \param wellbore_radius The radius of the well.
+             * \return A single list of BlockData objects for the whole well, in the order the blocks are first
+             * penetrated (mainbore first, then each lateral).
+             */
+            std::vector<IntersectedCell> ComputeWellBlocks(const WellTree &well_tree, double wellbore_radius);
+
+            /*!
+             * \brief Use a precomputed table of per-cell coefficients when computing well indices.
+             *
+             * Cells not contained in the table fall back to computing the coefficients from the cell.
+             * \param coefficient_table The table to use, or nullptr to stop using a table. The table is not
+             * owned by the calculator, and must outlive it.
+             */
+            void UseCoefficientTable(const WellIndexCoefficientTable *coefficient_table);
+
+            /*!
+             * \brief Make the traversal stop with a WellIndexCalculationCancelled exception when the token is
+             * cancelled or the deadline has passed. Both are checked between cells.
+             * \param cancellation_token The token to check.
+             * \param deadline The time after which the traversal is abandoned. Defaults to no deadline.
+             */
+            void UseCancellationToken(CancellationToken cancellation_token,
+                                      std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+            /*!
+             * \brief Given a reservoir with blocks and a line(start_point to end_point), return global index of all
+             * blocks interesected by the line, as well as the point where the line enters the block.
+             * by the line and the points of intersection
+             * \param start_point The start point of the well path.
+             * \param end_point The end point of the well path.
+             * \param grid The grid object containing blocks/cells.
+             * \return A pair containing global indeces of intersected cells and the points where it enters each cell
+             * (and thereby leaves the previous cell) of the line segment inside each cell.
+             */
+            std::vector<IntersectedCell> cells_intersected();
+
+            /*!
+             * \brief Find the point where the line bethween the start_point and end_point exits a cell.
+             *
+             * Takes as input an entry_point end_point which defines the well path. Finds the two points on the path
+             * which intersects the block faces and chooses the one that is not the entry point, i.e. the exit point.
+             *
+             * \todo Find a better name for the exception_point and describe it better.
+             *
+             * \param cell The cell to find the well paths exit point in.
+             * \param start_point The start point of the well path.
+             * \param end_point The end point of the well path.
+             * \param exception_point A specific point we don't want the function to end up in.
+             * \return The point where the well path exits the cell.
+             */
+            Vector3d find_exit_point(Grid::Cell &cell, Vector3d &start_point,
+                                     Vector3d &end_point, Vector3d &exception_point);
+
+            /*!
+             * \brief Find the point where the line between the entry_point and end_point exits a cell.
+             * \see find_exit_point(Grid::Cell &, Vector3d &, Vector3d &, Vector3d &)
+             */
+            Vector3d find_exit_point(const CellGeometry &cell, const Vector3d &entry_point,
+                                     const Vector3d &end_point, const Vector3d &exception_point) const;
+
+            /*!
+             * \brief Compute the well index (aka. transmissibility factor) for a (one) single cell/block by
+             * using the Projection Well Method (Shu 2005).
+             *
+             * Assumption: The block is fairly regular, i.e. corners are straight angles.
+             *
+             * \note Corner points of Cell(s) are always listed in the same order and orientation. (see
+             * Grid::Cell for illustration).
+             *
+             * \param icell Well block to compute the WI in.
+             * \return Well index for block/cell
+            */
+            double compute_well_index(IntersectedCell &icell);
+
+            /*!
+             * \brief Compute the well index for a cell from the projected lengths of the well segments in it.
+             * \param cell The well block.
+             * \param L The projected lengths (Lx, Ly, Lz), see projected_lengths.
+             */
+            double compute_well_index(const CellGeometry &cell, const Vector3d &L);
+
+            /*!
+             * \brief Compute the lengths of the projections of the well segments in a cell onto the
+             * directional spanning vectors of the cell.
+             * \param icell Well block to compute the projected lengths in.
+             * \return The projected lengths (Lx, Ly, Lz).
+             */
+            Vector3d projected_lengths(IntersectedCell &icell);
+
+            /*!
+             * \brief Compute the lengths of the projections of a single well segment onto the directional
+             * spanning vectors of a cell.
+             */
+            Vector3d projected_lengths(const CellGeometry &cell, const Vector3d &segment) const;
+
+            /*!
+             * \brief Auxilary function for compute_well_index function
+             * \param Lx lenght of projection in first direction
+             * \param dy size block second direction
+             * \param dz size block third direction
+             * \param ky permeability second direction
+             * \param kz permeability second direction
+             * \return directional well index
+            */
+            double dir_well_index(double Lx, double dy, double dz, double ky, double kz);
+
+            /*!
+             * \brief The permeability dependent factor of dir_well_index, i.e. the well index per unit
+             * projected length and unit log(wellblock radius/wellbore radius).
+             * \param ky permeability second direction
+             * \param kz permeability third direction
+             * \return directional well index factor
+             */
+            double dir_well_index_factor(double ky, double kz);
+
+            /*!
+             * \brief Auxilary function(2) for compute_well_index function
+             * \param dx size block second direction
+             * \param dy size block third direction
+             * \param kx permeability second direction
+             * \param ky permeability second direction
+             * \return directional wellblock radius
+             */
+            double dir_wellblock_radius(double dx, double dy, double kx, double ky);
+
+            /*!
+             * \brief Directional well index for a block in several realizations at once.
+             * \see dir_well_index(double, double, double, double, double)
+             */
+            ArrayXd dir_well_index(double Lx, double dy, double dz, const ArrayXd &ky, const ArrayXd &kz);
+
+            /*!
+             * \brief Directional wellblock radius for a block in several realizations at once.
+             * \see dir_wellblock_radius(double, double, double, double)
+             */
+            ArrayXd dir_wellblock_radius(double dx, double dy, const ArrayXd &kx, const ArrayXd &ky);
+
+        protected:
+            GridType *grid_; //!< The grid used in the calculations.
+            const WellIndexCoefficientTable *coefficient_table_ = nullptr; //!< Optional precomputed coefficients.
+            double wellbore_radius_;
+            Vector3d heel_;
+            Vector3d toe_;
+            CancellationToken cancellation_token_; //!< Token checked between cells in the traversal.
+            std::chrono::steady_clock::time_point deadline_ = std::chrono::steady_clock::time_point::max(); //!< Deadline checked between cells in the traversal.
+
+            /*!
+             * \brief Throw a WellIndexCalculationCancelled exception if the computation has been cancelled or
+             * has run past its deadline.
+             */
+            void check_cancellation() const;
+
+            /*!
+             * \brief A cell penetrated by the well path, along with the segment of the path inside it.
+             */
+            struct TraversedCell {
+                CellGeometry cell;
+                Vector3d entry_point;
+                Vector3d exit_point;
+            };
+
+            /*!
+             * \brief Find all cells penetrated by the line from heel_ to toe_, in order.
+             */
+            void traverse(std::vector<TraversedCell> &traversed_cells);
+
+            /*!
+             * \brief Create the IntersectedCell returned for a traversed cell.
+             */
+            IntersectedCell intersected_cell(const TraversedCell &traversed_cell) const;
+        };
+
+        template<class GridType>
+        std::vector<IntersectedCell> WellIndexCalculatorCore<GridType>::ComputeWellBlocks(Vector3d heel, Vector3d toe,
+                                                                                          double wellbore_radius) {
+            heel_ = heel;
+            toe_ = toe;
+            wellbore_radius_ = wellbore_radius;
+
+            std::vector<TraversedCell> traversed_cells;
+            traverse(traversed_cells);
+            std::vector<IntersectedCell> intersected_cells;
+            intersected_cells.reserve(traversed_cells.size());
+            for (auto &traversed_cell : traversed_cells) {
+                intersected_cells.push_back(intersected_cell(traversed_cell));
+                Vector3d L = projected_lengths(traversed_cell.cell, traversed_cell.exit_point - traversed_cell.entry_point);
+                intersected_cells.back().set_well_index(compute_well_index(traversed_cell.cell, L));
+            }
+            return intersected_cells;
+        }
+
+        template<class GridType>
+        std::vector<IntersectedCell> WellIndexCalculatorCore<GridType>::ComputeWellBlocks(const WellTree &well_tree,
+                                                                                          double wellbore_radius) {
+            wellbore_radius_ = wellbore_radius;
+
+            // Traverse every branch once, each with its own calculator, on the shared executor
+            auto &branches = well_tree.branches();
+            std::vector<std::vector<IntersectedCell>> branch_cells(branches.size());
+            Executor::Shared().ParallelFor(branches.size(), [this, &branches, &branch_cells](int b) {
+                WellIndexCalculatorCore<GridType> branch_wic(grid_);
+                branch_wic.UseCancellationToken(cancellation_token_, deadline_);
+                branch_wic.heel_ = branches[b].heel;
+                branch_wic.toe_ = branches[b].toe;
+                branch_cells[b] = branch_wic.cells_intersected();
+            });
+
+            // Merge the branches, so that each cell appears once with all the segments passing through it
+            std::vector<IntersectedCell> intersected_cells;
+            std::unordered_map<int, int> cell_positions;
+            for (auto &cells : branch_cells) {
+                for (auto &cell : cells) {
+                    auto position = cell_positions.find(cell.global_index());
+                    if (position == cell_positions.end()) {
+                        cell_positions[cell.global_index()] = intersected_cells.size();
+                        intersected_cells.push_back(cell);
+                    }
+                    else {
+                        intersected_cells[position->second].add_segment(cell.entry_point(), cell.exit_point());
+                    }
+                }
+            }
+
+            for (int i = 0; i < intersected_cells.size(); ++i) {
+                intersected_cells[i].set_well_index(compute_well_index(intersected_cells[i]));
+            }
+            return intersected_cells;
+        }
+
+        template<class GridType>
+        void WellIndexCalculatorCore<GridType>::UseCoefficientTable(const WellIndexCoefficientTable *coefficient_table) {
+            coefficient_table_ = coefficient_table;
+        }
+
+        template<class GridType>
+        void WellIndexCalculatorCore<GridType>::UseCancellationToken(CancellationToken cancellation_token,
+                                                                     std::chrono::steady_clock::time_point deadline) {
+            cancellation_token_ = cancellation_token;
+            deadline_ = deadline;
+        }
+
+        template<class GridType>
+        void WellIndexCalculatorCore<GridType>::check_cancellation() const {
+            if (cancellation_token_.IsCancelled())
+                throw WellIndexCalculationCancelled("WellIndexCalculator: The computation was cancelled.");
+            if (deadline_ != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() > deadline_)
+                throw WellIndexCalculationCancelled("WellIndexCalculator: The computation ran past its deadline.");
+        }
+
+        template<class GridType>
+        std::vector<IntersectedCell> WellIndexCalculatorCore<GridType>::cells_intersected() {
+            std::vector<TraversedCell> traversed_cells;
+            traverse(traversed_cells);
+            std::vector<IntersectedCell> intersected_cells;
+            intersected_cells.reserve(traversed_cells.size());
+            for (auto &traversed_cell : traversed_cells) {
+                intersected_cells.push_back(intersected_cell(traversed_cell));
+            }
+            return intersected_cells;
+        }
+
+        template<class GridType>
+        void WellIndexCalculatorCore<GridType>::traverse(std::vector<TraversedCell> &traversed_cells) {
+            traversed_cells.clear();
+
+            // Find the heel cell and add it to the list
+            traversed_cells.emplace_back();
+            GridAccess<GridType>::CellEnvelopingPoint(grid_, heel_, traversed_cells[0].cell);
+            traversed_cells[0].entry_point = heel_;
+
+            // Find the toe cell
+            CellGeometry last_cell;
+            GridAccess<GridType>::CellEnvelopingPoint(grid_, toe_, last_cell);
+
+            // If the first and last blocks are the same, return the block and start+end points
+            if (last_cell.global_index == traversed_cells[0].cell.global_index) {
+                traversed_cells[0].exit_point = toe_;
+                return;
+            }
+
+            // Make sure we follow line in the correct direction. (i.e. dot product positive)
+            Vector3d exit_point = find_exit_point(traversed_cells[0].cell, heel_, toe_, heel_);
+            if ((toe_ - heel_).dot(exit_point - heel_) <= 0.0) {
+                exit_point = find_exit_point(traversed_cells[0].cell, heel_, toe_, exit_point);
+            }
+            traversed_cells[0].exit_point = exit_point;
+
+            double epsilon = 0.01 / (toe_ - exit_point).norm();
+
+            // Add previous exit point to list, find next exit point and all other up to the end_point
+            while (true) {
+                check_cancellation();
+
+                // Move into the next cell, add it to the list and set the entry point
+                Vector3d move_exit_epsilon = exit_point * (1 - epsilon) + toe_ * epsilon;
+                traversed_cells.emplace_back();
+                TraversedCell &current = traversed_cells.back();
+                GridAccess<GridType>::CellEnvelopingPoint(grid_, move_exit_epsilon, current.cell);
+                current.entry_point = exit_point; // The entry point of each cell is the exit point of the previous cell
+
+                // Terminate if we're in the last cell
+                if (current.cell.global_index == last_cell.global_index) {
+                    current.exit_point = toe_;
+                    break;
+                }
+
+                // Find the exit point of the cell and set it in the list
+                exit_point = find_exit_point(current.cell, exit_point, toe_, exit_point);
+                current.exit_point = exit_point;
+                assert(traversed_cells.size() < 500);
+            }
+        }
+
+        template<class GridType>
+        IntersectedCell WellIndexCalculatorCore<GridType>::intersected_cell(const TraversedCell &traversed_cell) const {
+            IntersectedCell icell(traversed_cell.cell.ToCell());
+            icell.set_entry_point(traversed_cell.entry_point);
+            icell.set_exit_point(traversed_cell.exit_point);
+            return icell;
+        }
+
+        template<class GridType>
+        Vector3d WellIndexCalculatorCore<GridType>::find_exit_point(Grid::Cell &cell, Vector3d &entry_point,
+                                                      Vector3d &end_point, Vector3d &exception_point) {
+            return find_exit_point(CellGeometry(cell), entry_point, end_point, exception_point);
+        }
+
+        template<class GridType>
+        Vector3d WellIndexCalculatorCore<GridType>::find_exit_point(const CellGeometry &cell, const Vector3d &entry_point,
+                                                                    const Vector3d &end_point,
+                                                                    const Vector3d &exception_point) const {
+            Vector3d line = end_point - entry_point;
+
+            // Loop through the cell faces until we find one that the line intersects
+            for (int f = 0; f < 6; ++f) {
+                double normal_dot_line = cell.face_normals[f].dot(line);
+                if (normal_dot_line != 0) { // Check that the line and face are not parallel.
+                    Vector3d intersect_point = entry_point + line * cell.face_normals[f].dot(cell.face_points[f] - entry_point) / normal_dot_line;
+
+                    // Check that the intersect point is on the correct side of all faces (i.e. inside the cell)
+                    bool feasible_point = cell.Contains(intersect_point, 10e-6);
+
+                    // Return the point if it is deemed feasible, not identical to the entry point, and going in the correct direction.
+                    if (feasible_point && (exception_point - intersect_point).norm() > 10e-10
+                        && (end_point - entry_point).dot(end_point - intersect_point) >= 0) {
+                        return intersect_point;
+                    }
+                }
+            }
+            // If all fails, the line intersects the cell in a single point (corner or edge) -> return entry_point
+            return entry_point;
+        }
+
+        template<class GridType>
+        double WellIndexCalculatorCore<GridType>::compute_well_index(IntersectedCell &icell) {
+            CellGeometry cell(icell);
+            Vector3d L = Vector3d::Zero();
+            for (auto segment : icell.segments()) {
+                L += projected_lengths(cell, segment.second - segment.first);
+            }
+            return compute_well_index(cell, L);
+        }
+
+        template<class GridType>
+        double WellIndexCalculatorCore<GridType>::compute_well_index(const CellGeometry &cell, const Vector3d &L) {
+            if (coefficient_table_ != nullptr && coefficient_table_->contains(cell.global_index)) {
+                auto &c = coefficient_table_->coefficients(cell.global_index);
+                Array3d well_index = c.directional_factors.cast<double>().array() * L.array() /
+                                     (c.log_wellblock_radii.cast<double>().array() - log(wellbore_radius_));
+                return well_index.matrix().norm();
+            }
+
+            double dx = cell.xvec().norm();
+            double dy = cell.yvec().norm();
+            double dz = cell.zvec().norm();
+            double kx = cell.permeability.x();
+            double ky = cell.permeability.y();
+            double kz = cell.permeability.z();
+
+            // Compute Well Index from formula provided by Shu
+            double well_index_x = (dir_well_index(L.x(), dy, dz, ky, kz));
+            double well_index_y = (dir_well_index(L.y(), dx, dz, kx, kz));
+            double well_index_z = (dir_well_index(L.z(), dx, dy, kx, ky));
+            double wi = sqrt(well_index_x * well_index_x + well_index_y * well_index_y + well_index_z * well_index_z);
+            return wi;
+        }
+
+        template<class GridType>
+        Vector3d WellIndexCalculatorCore<GridType>::projected_lengths(IntersectedCell &icell) {
+            CellGeometry cell(icell);
+            Vector3d L = Vector3d::Zero();
+            for (auto segment : icell.segments()) {
+                L += projected_lengths(cell, segment.second - segment.first);
+            }
+            return L;
+        }
+
+        template<class GridType>
+        Vector3d WellIndexCalculatorCore<GridType>::projected_lengths(const CellGeometry &cell,
+                                                                      const Vector3d &segment) const {
+            /* Projects segment vector to directional spanning vectors and determines the length.
+             * of the projections. Note that we only only care about the length of the projection,
+             * not the spatial position.
+             */
+            if (coefficient_table_ != nullptr && coefficient_table_->contains(cell.global_index)) {
+                return (coefficient_table_->coefficients(cell.global_index).spanning_vectors.cast<double>() * segment).cwiseAbs();
+            }
+            Vector3d xvec = cell.xvec();
+            Vector3d yvec = cell.yvec();
+            Vector3d zvec = cell.zvec();
+            return Vector3d(std::abs(xvec.dot(segment)) / xvec.norm(),
+                            std::abs(yvec.dot(segment)) / yvec.norm(),
+                            std::abs(zvec.dot(segment)) / zvec.norm());
+        }
+
+        template<class GridType>
+        double WellIndexCalculatorCore<GridType>::dir_well_index(double Lx, double dy, double dz, double ky, double kz) {
+            double well_index_i = dir_well_index_factor(ky, kz) * Lx /
+                                  (log(dir_wellblock_radius(dy, dz, ky, kz) / wellbore_radius_));
+            return well_index_i;
+        }
+
+        template<class GridType>
+        double WellIndexCalculatorCore<GridType>::dir_well_index_factor(double ky, double kz) {
+            double silly_eclipse_factor = 0.008527;
+            return silly_eclipse_factor * 2 * M_PI * sqrt(ky * kz);
+        }
+
+        template<class GridType>
+        double WellIndexCalculatorCore<GridType>::dir_wellblock_radius(double dx, double dy, double kx, double ky) {
+            double r = 0.28 * sqrt((dx * dx) * sqrt(ky / kx) + (dy * dy) * sqrt(kx / ky)) /
+                       (sqrt(sqrt(kx / ky)) + sqrt(sqrt(ky / kx)));
+            return r;
+        }
+
+        template<class GridType>
+        ArrayXd WellIndexCalculatorCore<GridType>::dir_well_index(double Lx, double dy, double dz, const ArrayXd &ky, const ArrayXd &kz) {
+            double silly_eclipse_factor = 0.008527;
+            ArrayXd well_index_i = silly_eclipse_factor * (2 * M_PI * (ky * kz).sqrt() * Lx) /
+                                   (dir_wellblock_radius(dy, dz, ky, kz) / wellbore_radius_).log();
+            return well_index_i;
+        }
+
+        template<class GridType>
+        ArrayXd WellIndexCalculatorCore<GridType>::dir_wellblock_radius(double dx, double dy, const ArrayXd &kx, const ArrayXd &ky) {
+            ArrayXd r = 0.28 * ((dx * dx) * (ky / kx).sqrt() + (dy * dy) * (kx / ky).sqrt()).sqrt() /
+                        ((kx / ky).sqrt().sqrt() + (ky / kx).sqrt().sqrt());
+            return r;
+        }
+    }
+}
+
+#endif // WELLINDEXCALCULATOR_CORE_H